@@ -32,6 +32,9 @@ ADDON_INCLUDES += libs/cpp-httplib/include
 # addon
 # ADDON_CFLAGS =
 
+# Optional gzip transport compression (also link zlib, e.g. -lz below)
+# ADDON_CFLAGS += -DCPPHTTPLIB_ZLIB_SUPPORT
+
 # any special flag that should be passed to the linker when using this
 # addon, also used for system libraries with -lname
 # ADDON_LDFLAGS =
@@ -58,6 +61,8 @@ linux64:
 
 # For OpenSSL support in cpp-httplib
 ADDON_LIBS += -lssl -lcrypto
+# For CPPHTTPLIB_ZLIB_SUPPORT
+# ADDON_LIBS += -lz
 
 linux:
 # For OpenSSL support in cpp-httplib  
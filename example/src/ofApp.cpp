@@ -60,6 +60,11 @@ void ofApp::keyPressed(int key) {
 	db.keyPressed(key);
 }
 
+//--------------------------------------------------------------
+void ofApp::mouseScrolled(int x, int y, float scrollX, float scrollY) {
+	db.mouseScrolled(x, y, scrollX, scrollY);
+}
+
 //--------------------------------------------------------------
 void ofApp::exit() {
 	ofLogNotice("ofApp") << "exit()";
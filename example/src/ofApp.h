@@ -14,6 +14,7 @@ public:
 	void update();
 	void draw();
 	void keyPressed(int key);
+	void mouseScrolled(int x, int y, float scrollX, float scrollY);
 	void exit();
 
 private:
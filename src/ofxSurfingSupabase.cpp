@@ -1,19 +1,26 @@
 #include "ofxSurfingSupabase.h"
 
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include "../libs/cpp-httplib/include/httplib.h"
+#include "ofxSurfingSupabaseBackendLocal.h"
+#include "ofxSurfingSupabaseBackendSupabase.h"
+
+#include <deque>
+#include <filesystem>
+#include <fstream>
 
 // Constants
 const std::string ofxSurfingSupabase::CREDENTIALS_PATH = "credentials.txt";
-const std::string ofxSurfingSupabase::TABLE_NAME = "presets"; //TODO: to be used as kit name, alowing multiple kits
-//TODO: add tag to be used as kit name filtering for multiple kits
+const std::string ofxSurfingSupabase::CACHE_PATH = "ofxSurfingSupabase/cache";
+const std::string ofxSurfingSupabase::JOURNAL_PATH = "ofxSurfingSupabase/journal";
+const std::string ofxSurfingSupabase::LOCAL_PATH = "ofxSurfingSupabase/local";
+const std::string ofxSurfingSupabase::STATS_PATH = "ofxSurfingSupabase/stats.json";
 
 //--------------------------------------------------------------
 void ofxSurfingSupabase::setup(ofParameterGroup & sceneParams) {
 	ofLogNotice("ofxSurfingSupabase") << "setup(" << sceneParams.getName() << ")";
 
-	setup();
+	// Before setup(): a warm start may apply the cached selection
 	setupPresetParameters(sceneParams);
+	setup();
 }
 
 //--------------------------------------------------------------
@@ -21,12 +28,13 @@ void ofxSurfingSupabase::setup() {
 	ofLogNotice("ofxSurfingSupabase") << "setup()";
 
 	bConnected = false;
-	sceneParams_ = nullptr;
 	selectedPresetIndexRemote = -1;
 
 	setupParameters();
 	setupCallbacks();
 	setupGui();
+	setupCache();
+	setupJournal();
 	startup();
 }
 
@@ -36,6 +44,7 @@ void ofxSurfingSupabase::setupParameters() {
 
 	params_.setName("Supabase");
 	params_.add(bConnected);
+	params_.add(bRemoteMode);
 	params_.add(vReconnect);
 	params_.add(vRefreshListRemote);
 	params_.add(vClearDatabase);
@@ -70,9 +79,24 @@ void ofxSurfingSupabase::setupCallbacks() {
 		}
 	});
 
+	e_bDebug = bDebug.newListener([this](bool & b) {
+		auto backend = getBackend();
+		if (backend) backend->setDebug(b);
+	});
+
+	e_bRemoteMode = bRemoteMode.newListener([this](bool & b) {
+		// Remote: loads and writes go straight to Supabase, nothing is kept locally.
+		// Local-first: loads are served locally, writes are journaled, a replicator pulls remote changes.
+		ofLogNotice("ofxSurfingSupabase") << "Remote Mode: " << (b ? "remote" : "local-first");
+		replicaPullAt_ = 0;
+	});
+
 	e_vSaveToRemote = vSaveToRemote.newListener([this]() {
-		if (selectedPresetIndexRemote >= 0 && selectedPresetIndexRemote < presetsNamesRemote.size()) {
-			savePreset(presetsNamesRemote[selectedPresetIndexRemote.get()]);
+		std::string name = getSelectedPresetName();
+		if (!name.empty()) {
+			savePreset(name);
+		} else if (!selectedPresetName_.empty()) {
+			ofLogWarning("ofxSurfingSupabase") << "Save to Remote: " << selectedPresetName_ << " not listed yet";
 		}
 	});
 
@@ -81,8 +105,9 @@ void ofxSurfingSupabase::setupCallbacks() {
 	});
 
 	e_vLoadFromRemote = vLoadFromRemote.newListener([this]() {
-		if (selectedPresetIndexRemote >= 0 && selectedPresetIndexRemote < presetsNamesRemote.size()) {
-			loadPreset(presetsNamesRemote[selectedPresetIndexRemote.get()]);
+		std::string name = getSelectedPresetName();
+		if (!name.empty()) {
+			loadPreset(name);
 		}
 	});
 
@@ -91,8 +116,11 @@ void ofxSurfingSupabase::setupCallbacks() {
 	});
 
 	e_vDeleteSelected = vDeleteSelectedRemote.newListener([this]() {
-		if (selectedPresetIndexRemote >= 0 && selectedPresetIndexRemote < presetsNamesRemote.size()) {
-			deletePresetRemote(presetsNamesRemote[selectedPresetIndexRemote.get()]);
+		std::string name = getSelectedPresetName();
+		if (!name.empty()) {
+			deletePresetRemote(name);
+		} else if (!selectedPresetName_.empty()) {
+			ofLogWarning("ofxSurfingSupabase") << "Delete Selected: " << selectedPresetName_ << " not listed yet";
 		}
 	});
 
@@ -108,7 +136,8 @@ void ofxSurfingSupabase::setupCallbacks() {
 		selectPreviousRemote();
 	});
 
-	e_selectedPresetIndexRemote = selectedPresetIndexRemote.newListener([this](int & i) {
+	e_selectedPresetIndexRemote = selectedPresetIndexRemote.newListener([this](int &) {
+		if (bSelectionMoving_) return;
 		selectedIndexRemoteUpdate();
 	});
 }
@@ -133,9 +162,102 @@ void ofxSurfingSupabase::startup() {
 	}
 }
 
+//--------------------------------------------------------------
+void ofxSurfingSupabase::setupCache() {
+	ofLogNotice("ofxSurfingSupabase") << "setupCache()";
+
+	if (!cache_.open(ofToDataPath(CACHE_PATH, true))) return;
+
+	// Warm start: list and selection from disk, revalidated once connected
+	ofxSurfingSupabaseCache::State state;
+	if (!cache_.loadState(state)) return;
+
+	listUserId_ = state.userId;
+	presetsNamesRemote = state.names;
+	rebuildPresetIndex();
+	listWatermark_ = state.watermark;
+	replicaWatermark_ = state.replicaWatermark;
+	listSynced_ = state.synced;
+
+	++presetListGeneration_;
+	++presetListRevision_;
+	presetListPagesLoaded_.assign((presetsNamesRemote.size() + LIST_PAGE_SIZE - 1) / LIST_PAGE_SIZE, true);
+	for (std::size_t i = 0; i < presetsNamesRemote.size(); ++i) {
+		if (presetsNamesRemote[i].empty()) presetListPagesLoaded_[i / LIST_PAGE_SIZE] = false;
+	}
+
+	updateSelectedIndexRange();
+
+	int selected = state.selected.empty() ? -1 : findPresetIndex(state.selected);
+	if (selected >= 0) {
+		selectedPresetIndexRemote = selected;
+	}
+
+	ofLogNotice("ofxSurfingSupabase") << "setupCache(): ✓ Restored " << presetsNamesRemote.size() << " presets, " << cache_.size() << " cached";
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::saveCacheState() {
+	if (!cache_.isOpen()) return;
+
+	ofxSurfingSupabaseCache::State state;
+	state.userId = listUserId_;
+	state.names = presetsNamesRemote;
+	state.selected = selectedPresetName_.empty() ? getSelectedPresetName() : selectedPresetName_;
+	state.watermark = listWatermark_;
+	state.replicaWatermark = replicaWatermark_;
+	state.synced = listSynced_;
+	cache_.saveState(state);
+	cache_.flush();
+
+	cacheStateRevision_ = presetListRevision_;
+	cacheStateSelected_ = selectedPresetIndexRemote.get();
+	cacheStateTime_ = ofGetElapsedTimef();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::setupJournal() {
+	ofLogNotice("ofxSurfingSupabase") << "setupJournal()";
+
+	if (!journal_.open(ofToDataPath(JOURNAL_PATH, true))) return;
+
+	// The warm started list holds the saves still queued, the remote may not
+	for (auto & name : journal_.getPendingNames()) {
+		if (findPresetIndex(name) >= 0) presetNamesUnpushed_.insert(name);
+	}
+
+	journalThreadRunning_ = true;
+	journalThread_ = std::thread(&ofxSurfingSupabase::journalThreadFunction, this);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::stopJournalThread() {
+	if (!journalThread_.joinable()) return;
+
+	journalThreadRunning_ = false;
+	journalCondition_.notify_one();
+	journalThread_.join();
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::~ofxSurfingSupabase() {
+	stopJournalThread();
+}
+
 //--------------------------------------------------------------
 void ofxSurfingSupabase::exit() {
 	ofLogNotice("ofxSurfingSupabase") << "exit()";
+
+	stopJournalThread();
+	journal_.close();
+
+	if (bDebug) {
+		logBackendStats();
+		exportBackendStats(ofToDataPath(STATS_PATH, true));
+	}
+
+	saveCacheState();
+	cache_.close();
 }
 
 //--------------------------------------------------------------
@@ -144,10 +266,31 @@ void ofxSurfingSupabase::setupPresetParameters(ofParameterGroup & sceneParams) {
 	sceneParams_ = &sceneParams;
 }
 
+//--------------------------------------------------------------
+void ofxSurfingSupabase::setBackend(std::shared_ptr<ofxSurfingSupabaseBackend> backend) {
+	ofLogNotice("ofxSurfingSupabase") << "setBackend(" << (backend ? backend->getName() : "") << ")";
+
+	std::lock_guard<std::mutex> lock(backendMutex_);
+	backend_ = backend;
+	bBackendExternal_ = (backend != nullptr);
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<ofxSurfingSupabaseBackend> ofxSurfingSupabase::getBackend() const {
+	std::lock_guard<std::mutex> lock(backendMutex_);
+	return backend_;
+}
+
 //--------------------------------------------------------------
 bool ofxSurfingSupabase::loadCredentials() {
 	ofLogNotice("ofxSurfingSupabase") << "loadCredentials()";
 
+	// A backend passed with setBackend() needs no credentials file
+	{
+		std::lock_guard<std::mutex> lock(backendMutex_);
+		if (bBackendExternal_) return backend_ != nullptr;
+	}
+
 	std::string path = ofToDataPath(CREDENTIALS_PATH);
 	ofFile file(path);
 
@@ -156,6 +299,10 @@ bool ofxSurfingSupabase::loadCredentials() {
 		return false;
 	}
 
+	ofxSurfingSupabaseBackendSupabase::Config config;
+	std::string backendType;
+	std::string localPath = LOCAL_PATH;
+
 	ofBuffer buffer = file.readToBuffer();
 	for (auto & line : buffer.getLines()) {
 		if (line.empty() || line[0] == '#') continue;
@@ -170,316 +317,404 @@ bool ofxSurfingSupabase::loadCredentials() {
 		value.erase(0, value.find_first_not_of(" \t\r\n"));
 		value.erase(value.find_last_not_of(" \t\r\n") + 1);
 
-		if (key == "AUTH_MODE")
-			config_.authMode = value;
+		if (key == "BACKEND")
+			backendType = value;
+		else if (key == "LOCAL_PATH")
+			localPath = value;
+		else if (key == "AUTH_MODE")
+			config.authMode = value;
 		else if (key == "SUPABASE_URL") {
-			config_.supabaseUrl = value;
+			config.supabaseUrl = value;
 			// Remove trailing slashes
-			while (!config_.supabaseUrl.empty() && config_.supabaseUrl.back() == '/') {
-				config_.supabaseUrl.pop_back();
+			while (!config.supabaseUrl.empty() && config.supabaseUrl.back() == '/') {
+				config.supabaseUrl.pop_back();
 			}
 		} else if (key == "SUPABASE_ANON_KEY")
-			config_.supabaseAnonKey = value;
+			config.supabaseAnonKey = value;
 		else if (key == "EMAIL")
-			config_.email = value;
+			config.email = value;
 		else if (key == "PASSWORD")
-			config_.password = value;
+			config.password = value;
+		else if (key == "COMPRESS_THRESHOLD")
+			config.compressThreshold = ofToInt(value);
+		else if (key == "CA_BUNDLE")
+			config.caBundle = value;
+		else if (key == "TLS_VERIFY")
+			config.verifyTls = (value != "OFF");
+		else if (key == "RATE_LIMIT_READ")
+			config.readRate = ofToDouble(value);
+		else if (key == "RATE_LIMIT_WRITE")
+			config.writeRate = ofToDouble(value);
 	}
 
-	if (bDebug) {
-		ofLogNotice("ofxSurfingSupabase") << "Auth mode: " << config_.authMode;
-		ofLogNotice("ofxSurfingSupabase") << "URL: " << config_.supabaseUrl;
+	std::shared_ptr<ofxSurfingSupabaseBackend> backend;
+
+	if (backendType == "LOCAL") {
+		// No network at all: presets live in a local folder
+		backend = std::make_shared<ofxSurfingSupabaseBackendLocal>(ofToDataPath(localPath, true));
+	} else {
+		if (bDebug) {
+			ofLogNotice("ofxSurfingSupabase") << "Auth mode: " << config.authMode;
+			ofLogNotice("ofxSurfingSupabase") << "URL: " << config.supabaseUrl;
+		}
+
+		if (!config.isValid()) return false;
+		backend = std::make_shared<ofxSurfingSupabaseBackendSupabase>(config);
 	}
 
-	return config_.isValid();
+	std::lock_guard<std::mutex> lock(backendMutex_);
+	backend_ = backend;
+	return true;
 }
 
 //--------------------------------------------------------------
 bool ofxSurfingSupabase::authenticate() {
 	ofLogNotice("ofxSurfingSupabase") << "authenticate()";
 
-	// Check auth mode
-	if (config_.authMode == "ANON_KEY") {
-		// Simple mode: just use anon key, no email/password
-		ofLogNotice("ofxSurfingSupabase") << "Using ANON_KEY authentication (no user login)";
-
-		// Use anon key as auth token
-		authToken_ = config_.supabaseAnonKey;
-		userId_ = "anonymous"; // No real user ID
-		bConnected = true;
-
-		ofLogNotice("ofxSurfingSupabase") << "✓ Connected with ANON_KEY";
-		return true;
-	} else if (config_.authMode == "EMAIL_PASSWORD") {
-		// Full auth mode: login with email/password
-		ofLogNotice("ofxSurfingSupabase") << "Using EMAIL_PASSWORD authentication";
-
-		try {
-			// Extract host from URL
-			std::string host = config_.supabaseUrl;
-			if (host.find("https://") == 0) {
-				host = host.substr(8);
-			} else if (host.find("http://") == 0) {
-				host = host.substr(7);
-			}
+	auto backend = getBackend();
+	if (!backend) {
+		bConnected = false;
+		setJournalSession(false);
+		return false;
+	}
 
-			// Create HTTPS client
-			httplib::SSLClient client(host);
-			client.set_connection_timeout(10, 0);
-			client.set_read_timeout(10, 0);
-			client.set_write_timeout(10, 0);
-			client.enable_server_certificate_verification(false);
-
-			// Build auth request
-			ofJson authData;
-			authData["email"] = config_.email;
-			authData["password"] = config_.password;
-			std::string body = authData.dump();
-
-			// Set headers
-			httplib::Headers headers = {
-				{ "Content-Type", "application/json" },
-				{ "apikey", config_.supabaseAnonKey }
-			};
-
-			// Perform authentication
-			auto res = client.Post("/auth/v1/token?grant_type=password", headers, body, "application/json");
-
-			if (res && res->status == 200) {
-				try {
-					ofJson responseJson = ofJson::parse(res->body);
-					authToken_ = responseJson["access_token"].get<std::string>();
-					userId_ = responseJson["user"]["id"].get<std::string>();
-					bConnected = true;
-
-					ofLogNotice("ofxSurfingSupabase") << "✓ Authenticated successfully";
-					if (bDebug) {
-						ofLogNotice("ofxSurfingSupabase") << "User ID: " << userId_;
-					}
-
-					return true;
-				} catch (std::exception & e) {
-					ofLogError("ofxSurfingSupabase") << "Failed to parse auth response: " << e.what();
-				}
-			} else {
-				std::string errorMsg = res ? res->body : "Connection failed";
-				ofLogError("ofxSurfingSupabase") << "✗ Authentication failed: HTTP " << (res ? res->status : 0);
-				if (!res) {
-					ofLogError("ofxSurfingSupabase") << "Error: " << httplib::to_string(res.error());
-				}
-				if (bDebug) {
-					ofLogError("ofxSurfingSupabase") << errorMsg;
-				}
-			}
-		} catch (std::exception & e) {
-			ofLogError("ofxSurfingSupabase") << "Exception during authentication: " << e.what();
-		}
-	} else {
-		ofLogError("ofxSurfingSupabase") << "Unknown AUTH_MODE: " << config_.authMode;
-		ofLogError("ofxSurfingSupabase") << "Supported modes: ANON_KEY, EMAIL_PASSWORD";
+	backend->setDebug(bDebug);
+
+	if (!backend->connect()) {
+		bConnected = false;
+		setJournalSession(false);
+		return false;
 	}
 
-	bConnected = false;
-	return false;
+	userId_ = backend->getUserId();
+	setupSessionUser();
+	bConnected = true;
+	setJournalSession(true);
+
+	ofLogNotice("ofxSurfingSupabase") << "✓ Connected to " << backend->getName() << " backend";
+	return true;
 }
 
 //--------------------------------------------------------------
-ofxSurfingSupabase::HttpResponse ofxSurfingSupabase::httpGet(const std::string & endpoint) {
-	HttpResponse result;
-	result.success = false;
+void ofxSurfingSupabase::setupSessionUser() {
+	if (userId_ == listUserId_) return;
 
-	if (!bConnected) {
-		result.statusCode = 0;
-		result.body = "Not connected";
-		return result;
+	// The restored list and cache belong to another user: start from scratch
+	if (!listUserId_.empty()) {
+		ofLogNotice("ofxSurfingSupabase") << "setupSessionUser(): User changed, dropping cache";
 	}
 
-	try {
-		std::string host = config_.supabaseUrl;
-		if (host.find("https://") == 0) {
-			host = host.substr(8);
-		} else if (host.find("http://") == 0) {
-			host = host.substr(7);
+	cache_.clear();
+	presetsNamesRemote.clear();
+	presetIndexByName_.clear();
+	presetNamesUnpushed_.clear();
+	selectedPresetName_.clear();
+	listWatermark_.clear();
+	replicaWatermark_.clear();
+	listSynced_ = false;
+	listUserId_ = userId_;
+	++presetListGeneration_;
+	++presetListRevision_;
+	presetListPagesLoaded_.clear();
+	presetListPagesInFlight_.clear();
+	updateSelectedIndexRange();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::update() {
+	if (hasPendingPreset_.load()) {
+		std::string presetData;
+		std::string presetName;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetMutex_);
+			presetData = pendingPresetJson_;
+			presetName = pendingPresetName_;
+			pendingPresetJson_.clear();
+			pendingPresetName_.clear();
+			hasPendingPreset_ = false;
 		}
 
-		if (bDebug) {
-			ofLogNotice("ofxSurfingSupabase") << "HTTP GET: " << endpoint;
-			ofLogNotice("ofxSurfingSupabase") << "Host: " << host;
+		if (!presetData.empty()) {
+			deserializeJsonToScene(presetData);
+			ofLogNotice("ofxSurfingSupabase") << "loadPreset(): ✓ Preset loaded and applied (" << presetName << ")";
+		}
+	}
+
+	if (hasPendingPresetListSync_.load()) {
+		PresetListSync sync;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			sync = std::move(pendingPresetListSync_);
+			hasPendingPresetListSync_ = false;
 		}
 
-		httplib::SSLClient client(host);
-		client.set_connection_timeout(10, 0);
-		client.set_read_timeout(10, 0);
-		client.enable_server_certificate_verification(false); // Disable cert verification for testing
+		if (sync.generation == presetListGeneration_) {
+			applyPresetListSync(sync);
+		}
+		isRefreshingRemote_ = false;
 
-		httplib::Headers headers = {
-			{ "apikey", config_.supabaseAnonKey },
-			{ "Authorization", "Bearer " + authToken_ }
-		};
+		if (bRefreshQueued_) {
+			bRefreshQueued_ = false;
+			refreshPresetListRemote();
+		}
+	}
 
-		auto res = client.Get(endpoint.c_str(), headers);
+	// Before the added names: those confirmed since are saves queued behind the wipe
+	if (hasPendingClear_.exchange(false)) {
+		applyDatabaseCleared();
+	}
 
-		if (res) {
-			result.statusCode = res->status;
-			result.body = res->body;
-			result.success = (res->status >= 200 && res->status < 300);
+	if (hasPendingPresetNamesAdded_.load()) {
+		std::vector<std::string> namesAdded;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			namesAdded.swap(pendingPresetNamesAdded_);
+			hasPendingPresetNamesAdded_ = false;
+		}
 
-			if (bDebug) {
-				ofLogNotice("ofxSurfingSupabase") << "Response: HTTP " << result.statusCode;
-			}
-		} else {
-			auto err = res.error();
-			ofLogError("ofxSurfingSupabase") << "HTTP GET failed - Error: " << httplib::to_string(err);
-			result.statusCode = 0;
-			result.body = "Connection error: " + std::string(httplib::to_string(err));
+		// The watermark stays put: other clients' rows stamped before ours are still to fetch
+		for (auto & name : namesAdded) {
+			presetNamesUnpushed_.erase(name);
+			patchPresetNameAdded(name);
 		}
-	} catch (std::exception & e) {
-		ofLogError("ofxSurfingSupabase") << "HTTP GET exception: " << e.what();
 	}
 
-	return result;
-}
+	// Rejected saves of new presets leave the list, existing ones stay listed
+	if (hasPendingPresetNamesDropped_.load()) {
+		std::vector<std::string> namesDropped;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			namesDropped.swap(pendingPresetNamesDropped_);
+			hasPendingPresetNamesDropped_ = false;
+		}
 
-//--------------------------------------------------------------
-ofxSurfingSupabase::HttpResponse ofxSurfingSupabase::httpPost(const std::string & endpoint, const std::string & jsonBody) {
-	HttpResponse result;
-	result.success = false;
+		std::vector<std::string> namesRemoved;
+		for (auto & name : namesDropped) {
+			ofLogWarning("ofxSurfingSupabase") << "⚠️  Save rejected by the remote, not saved: " << name;
+			if (presetNamesUnpushed_.count(name) > 0) namesRemoved.push_back(name);
+		}
+		patchPresetNamesRemoved(namesRemoved);
+	}
 
-	if (!bConnected) {
-		result.statusCode = 0;
-		result.body = "Not connected";
-		return result;
+	// A replayed delete asks for a list refresh
+	if (hasPendingRefresh_.exchange(false)) {
+		refreshPresetListRemote();
 	}
 
-	try {
-		std::string host = config_.supabaseUrl;
-		if (host.find("https://") == 0) {
-			host = host.substr(8);
-		} else if (host.find("http://") == 0) {
-			host = host.substr(7);
-		}
-
-		httplib::SSLClient client(host);
-		client.set_connection_timeout(10, 0);
-		client.set_read_timeout(10, 0);
-		client.enable_server_certificate_verification(false);
-
-		httplib::Headers headers = {
-			{ "apikey", config_.supabaseAnonKey },
-			{ "Authorization", "Bearer " + authToken_ },
-			{ "Content-Type", "application/json" },
-			{ "Prefer", "resolution=merge-duplicates" }
-		};
-
-		auto res = client.Post(endpoint.c_str(), headers, jsonBody, "application/json");
-
-		if (res) {
-			result.statusCode = res->status;
-			result.body = res->body;
-			result.success = (res->status >= 200 && res->status < 300);
-		} else {
-			auto err = res.error();
-			ofLogError("ofxSurfingSupabase") << "HTTP POST failed - Error: " << httplib::to_string(err);
-			result.statusCode = 0;
-			result.body = "Connection error: " + std::string(httplib::to_string(err));
+	if (hasPendingPresetPages_.load()) {
+		std::vector<PresetListPage> pages;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			pages.swap(pendingPresetPages_);
+			hasPendingPresetPages_ = false;
+		}
+
+		for (auto & page : pages) {
+			if (page.generation != presetListGeneration_) continue; // Stale, list was reset
+			if (page.success) {
+				applyPresetListPage(page.page, page.names, page.total);
+			} else {
+				presetListPagesInFlight_.erase(page.page);
+			}
 		}
-	} catch (std::exception & e) {
-		ofLogError("ofxSurfingSupabase") << "HTTP POST exception: " << e.what();
 	}
 
-	return result;
+	// Local-first: pull remote changes into the local store in the background
+	if (hasPendingReplicaPull_.load()) {
+		ReplicaPull pull;
+		{
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			pull = std::move(pendingReplicaPull_);
+			hasPendingReplicaPull_ = false;
+		}
+
+		applyReplicaPull(pull);
+		isReplicatingRemote_ = false;
+	}
+
+	if (!bRemoteMode && bConnected && !isReplicatingRemote_ && ofGetElapsedTimeMillis() >= replicaPullAt_) {
+		startReplicaPull();
+	}
+
+	// Load pages on demand around the selection and the visible window
+	if (!presetsNamesRemote.empty()) {
+		int selected = std::max(0, selectedPresetIndexRemote.get());
+		requestPresetListPages(selected - LIST_PAGE_SIZE / 2, selected + LIST_PAGE_SIZE / 2);
+		requestPresetListPages(listScrollOffset_, listScrollOffset_ + LIST_ROWS_VISIBLE);
+	}
+
+	// Auto load deferred until the selected name arrived with its page
+	if (bAutoLoadDeferred_ && !getSelectedPresetName().empty()) {
+		bAutoLoadDeferred_ = false;
+		selectedPresetName_ = getSelectedPresetName();
+		loadAndApplyRemote();
+	}
+
+	// Persist list and selection for the next warm start, throttled
+	if ((presetListRevision_ != cacheStateRevision_ || selectedPresetIndexRemote.get() != cacheStateSelected_)
+		&& ofGetElapsedTimef() - cacheStateTime_ > 2.0f) {
+		saveCacheState();
+	}
 }
 
 //--------------------------------------------------------------
-ofxSurfingSupabase::HttpResponse ofxSurfingSupabase::httpDelete(const std::string & endpoint) {
-	HttpResponse result;
-	result.success = false;
+int ofxSurfingSupabase::findPresetIndex(const std::string & name) const {
+	auto it = presetIndexByName_.find(name);
+	if (it == presetIndexByName_.end()) return -1;
+	return it->second;
+}
 
-	if (!bConnected) {
-		result.statusCode = 0;
-		result.body = "Not connected";
-		return result;
+//--------------------------------------------------------------
+void ofxSurfingSupabase::setPresetName(std::size_t index, const std::string & name) {
+	std::string & slot = presetsNamesRemote[index];
+	if (slot == name) return;
+
+	// A name moved by a page fetched after a shift keeps only its newest slot
+	if (!slot.empty()) {
+		auto it = presetIndexByName_.find(slot);
+		if (it != presetIndexByName_.end() && it->second == static_cast<int>(index)) presetIndexByName_.erase(it);
 	}
+	slot = name;
+	if (!name.empty()) presetIndexByName_[name] = static_cast<int>(index);
+}
 
-	try {
-		std::string host = config_.supabaseUrl;
-		if (host.find("https://") == 0) {
-			host = host.substr(8);
-		} else if (host.find("http://") == 0) {
-			host = host.substr(7);
-		}
+//--------------------------------------------------------------
+void ofxSurfingSupabase::rebuildPresetIndex() {
+	presetIndexByName_.clear();
+	presetIndexByName_.reserve(presetsNamesRemote.size());
+	for (std::size_t i = 0; i < presetsNamesRemote.size(); ++i) {
+		if (!presetsNamesRemote[i].empty()) presetIndexByName_[presetsNamesRemote[i]] = static_cast<int>(i);
+	}
+}
 
-		httplib::SSLClient client(host);
-		client.set_connection_timeout(10, 0);
-		client.set_read_timeout(10, 0);
-		client.enable_server_certificate_verification(false);
+//--------------------------------------------------------------
+int ofxSurfingSupabase::countPresetNamesUnpushed() {
+	// Saves the journal dropped (superseded or rejected) won't be confirmed either
+	std::unordered_set<std::string> pending;
+	for (auto & name : journal_.getPendingNames()) {
+		if (presetNamesUnpushed_.count(name) > 0) pending.insert(name);
+	}
+	presetNamesUnpushed_.swap(pending);
+	return static_cast<int>(presetNamesUnpushed_.size());
+}
 
-		httplib::Headers headers = {
-			{ "apikey", config_.supabaseAnonKey },
-			{ "Authorization", "Bearer " + authToken_ }
-		};
+//--------------------------------------------------------------
+void ofxSurfingSupabase::mergePresetNamesUnpushed() {
+	// Appended in save order behind the remote rows, as the journal will insert them
+	countPresetNamesUnpushed();
+	for (auto & name : journal_.getPendingNames()) {
+		if (presetNamesUnpushed_.count(name) > 0) patchPresetNameAdded(name);
+	}
+}
 
-		auto res = client.Delete(endpoint.c_str(), headers);
+//--------------------------------------------------------------
+void ofxSurfingSupabase::patchPresetNameAdded(const std::string & name) {
+	// Upserts of existing names keep their slot,
+	// new rows are appended as the list is ordered by created_at.asc
+	if (findPresetIndex(name) >= 0) return;
+
+	presetsNamesRemote.push_back(name);
+	presetIndexByName_[name] = static_cast<int>(presetsNamesRemote.size()) - 1;
+	ofLogNotice("ofxSurfingSupabase") << "✓ Patched list: " << presetsNamesRemote.size() << " presets";
+
+	++presetListRevision_;
+	resizePresetListPages();
+	updateSelectedIndexRange();
+}
 
-		if (res) {
-			result.statusCode = res->status;
-			result.body = res->body;
-			result.success = (res->status >= 200 && res->status < 300);
-		} else {
-			auto err = res.error();
-			ofLogError("ofxSurfingSupabase") << "HTTP DELETE failed - Error: " << httplib::to_string(err);
-			result.statusCode = 0;
-			result.body = "Connection error: " + std::string(httplib::to_string(err));
+//--------------------------------------------------------------
+void ofxSurfingSupabase::patchPresetNamesRemoved(const std::vector<std::string> & names) {
+	std::unordered_set<std::string> removed(names.begin(), names.end());
+
+	// One pass; the selection keeps its preset, or the next one slides under it
+	int selected = selectedPresetIndexRemote.get();
+	int selectedShift = 0;
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < presetsNamesRemote.size(); ++i) {
+		if (!presetsNamesRemote[i].empty() && removed.count(presetsNamesRemote[i]) > 0) {
+			if (static_cast<int>(i) < selected) ++selectedShift;
+			presetIndexByName_.erase(presetsNamesRemote[i]);
+			presetNamesUnpushed_.erase(presetsNamesRemote[i]);
+			continue;
 		}
-	} catch (std::exception & e) {
-		ofLogError("ofxSurfingSupabase") << "HTTP DELETE exception: " << e.what();
+		if (kept != i) {
+			presetsNamesRemote[kept] = std::move(presetsNamesRemote[i]);
+			if (!presetsNamesRemote[kept].empty()) presetIndexByName_[presetsNamesRemote[kept]] = static_cast<int>(kept);
+		}
+		++kept;
 	}
+	if (kept == presetsNamesRemote.size()) return;
 
-	return result;
+	std::size_t count = presetsNamesRemote.size() - kept;
+	presetsNamesRemote.resize(kept);
+	if (removed.count(selectedPresetName_) > 0) {
+		selectedPresetName_.clear(); // Gone for good, the next preset takes over
+	}
+	ofLogNotice("ofxSurfingSupabase") << "✓ Patched list: " << count << " removed, " << presetsNamesRemote.size() << " presets";
+
+	// Unloaded pages shifted with the rows: reload them with the refresh after the delete
+	if (!isPresetListComplete()) {
+		listSynced_ = false;
+	}
+
+	++presetListRevision_;
+	resizePresetListPages();
+	if (selected >= 0) {
+		selectedPresetIndexRemote.setWithoutEventNotifications(selected - selectedShift);
+	}
+	updateSelectedIndexRange();
+	clampPresetListScroll();
 }
 
 //--------------------------------------------------------------
-void ofxSurfingSupabase::update() {
-	if (hasPendingPreset_.load()) {
-		std::string presetData;
-		std::string presetName;
-		{
-			std::lock_guard<std::mutex> lock(pendingPresetMutex_);
-			presetData = pendingPresetJson_;
-			presetName = pendingPresetName_;
-			pendingPresetJson_.clear();
-			pendingPresetName_.clear();
-			hasPendingPreset_ = false;
-		}
-
-		if (!presetData.empty()) {
-			deserializeJsonToScene(presetData);
-			ofLogNotice("ofxSurfingSupabase") << "loadPreset(): ✓ Preset loaded and applied (" << presetName << ")";
-		}
+void ofxSurfingSupabase::updateSelectedIndexRange() {
+	int newMin = presetsNamesRemote.empty() ? -1 : 0;
+	int newMax = presetsNamesRemote.empty() ? -1 : static_cast<int>(presetsNamesRemote.size()) - 1;
+
+	// Keep the selection on its preset by name, wherever the list moved it
+	int value = findPresetIndex(selectedPresetName_);
+	if (value < 0) {
+		value = presetsNamesRemote.empty() ? -1 : ofClamp(selectedPresetIndexRemote.get(), newMin, newMax);
 	}
 
-	if (hasPendingPresetList_.load()) {
-		std::vector<std::string> presetList;
-		{
-			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
-			presetList = pendingPresetList_;
-			pendingPresetList_.clear();
-			hasPendingPresetList_ = false;
-		}
+	// Still notified for the gui, but moving the index is not a new selection
+	bSelectionMoving_ = true;
+	if (selectedPresetIndexRemote.getMin() != newMin || selectedPresetIndexRemote.getMax() != newMax) {
+		selectedPresetIndexRemote.set(selectedPresetIndexRemote.getName(), value, newMin, newMax);
+	} else if (selectedPresetIndexRemote.get() != value) {
+		selectedPresetIndexRemote = value;
+	}
+	bSelectionMoving_ = false;
 
-		presetsNamesRemote = presetList;
-		ofLogNotice("ofxSurfingSupabase") << "✓ Found " << presetsNamesRemote.size() << " presets";
+	// Its preset is gone, or none was selected yet: the one under the index takes over.
+	// While pages are missing it may just not be loaded yet.
+	std::string name = getSelectedIndexName();
+	if (name.empty() || name == selectedPresetName_) return;
+	if (!selectedPresetName_.empty() && !isPresetListComplete()) return;
 
-		int newMin = presetsNamesRemote.empty() ? -1 : 0;
-		int newMax = presetsNamesRemote.empty() ? -1 : static_cast<int>(presetsNamesRemote.size()) - 1;
-		int value = presetsNamesRemote.empty() ? -1 : ofClamp(selectedPresetIndexRemote.get(), newMin, newMax);
+	selectedIndexRemoteUpdate();
+}
 
-		if (selectedPresetIndexRemote.getMin() != newMin || selectedPresetIndexRemote.getMax() != newMax) {
-			selectedPresetIndexRemote.set(selectedPresetIndexRemote.getName(), value, newMin, newMax);
-		} else {
-			selectedPresetIndexRemote = value;
+//--------------------------------------------------------------
+void ofxSurfingSupabase::onPresetSaved(const ofxSurfingSupabaseBackend::Row & saved, const std::string & payload) {
+	// Called from worker threads with the row returned by a save.
+	// A later local save of the same name, still pending, keeps its copy.
+	// Remote mode keeps no copy of its own, only those left by local-first are refreshed.
+	ofxSurfingSupabaseCache::Info info;
+	bool cached = cache_.getInfo(saved.name, info);
+	bool keep = cached ? (!info.updatedAt.empty() || info.hash == ofxSurfingSupabaseCache::hashPayload(payload)) : !bRemoteMode;
+	if (keep) {
+		if (!saved.updatedAt.empty()) {
+			cache_.put(saved.name, payload, saved.updatedAt);
+		} else if (cached) {
+			// Server stamp unknown: an empty one would read as pending forever, the next load fetches it
+			cache_.erase(saved.name);
 		}
 	}
+
+	std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+	pendingPresetNamesAdded_.push_back(saved.name);
+	hasPendingPresetNamesAdded_ = true;
 }
 
 //--------------------------------------------------------------
@@ -511,485 +746,1900 @@ void ofxSurfingSupabase::draw() {
 
 	gui_.draw();
 
+	uint64_t timeStart = ofGetElapsedTimeMicros();
+
 	// Draw status
 	int x = gui_.getPosition().x + 5;
 	int y = gui_.getPosition().y + gui_.getHeight() + 20;
-	int p = 20;
 
+	// Overlays are rendered into cached fbos and only redrawn when their state changes.
+	// What the user drives is checked every frame; the stats (a locked query per op class)
+	// are only gathered on the poll interval, or right before such a redraw.
 	if (bDebug) {
-
-		// Status
-		std::string status = "Status: ";
-		ofColor statusColor;
-		if (bConnected) {
-			status += "CONNECTED";
-			statusColor = ofColor::green;
-		} else {
-			status += "DISCONNECTED";
-			statusColor = ofColor::red;
-		}
-		ofDrawBitmapStringHighlight(status, x, y, ofColor::black, statusColor);
-
-		y = y + p;
-		if (isLoadingRemote_.load()) {
-			static const std::string spinner = "|/-\\";
-			char tick = spinner[ofGetFrameNum() % spinner.size()];
-			std::string wait = "Loading preset  " + std::string(1, tick);
-			ofDrawBitmapStringHighlight(wait, x, y, ofColor::black, ofColor::yellow);
-		} else if (isSavingRemote_.load()) {
-			static const std::string spinner = "|/-\\";
-			char tick = spinner[ofGetFrameNum() % spinner.size()];
-			std::string wait = "Saving preset   " + std::string(1, tick);
-			ofDrawBitmapStringHighlight(wait, x, y, ofColor::black, ofColor::yellow);
-		} else {
-			std::string wait = "                 ";
-			ofDrawBitmapStringHighlight(wait, x, y, ofColor::black, ofColor::yellow);
-		}
-
-		// Selected
-		if (!presetsNamesRemote.empty() && selectedPresetIndexRemote >= 0 && selectedPresetIndexRemote < presetsNamesRemote.size()) {
-			y = y + p;
-			std::string presetInfo = "Selected: " + presetsNamesRemote[selectedPresetIndexRemote.get()];
-			presetInfo += " (" + ofToString(selectedPresetIndexRemote.get()) + "/" + ofToString(presetsNamesRemote.size() - 1) + ")";
-			ofSetColor(255);
-			ofDrawBitmapStringHighlight(presetInfo, x, y);
+		uint64_t now = ofGetElapsedTimeMillis();
+		bool listChanged = selectedPresetIndexRemote.get() != statusPanelState_.selected
+			|| listScrollOffset_ != statusPanelState_.scrollOffset || presetListRevision_ != statusPanelState_.listRevision;
+
+		if (!statusPanelFbo_.isAllocated() || listChanged || now >= overlayRefreshAt_) {
+			overlayRefreshAt_ = now + OVERLAY_REFRESH_MS;
+			OverlayState state = getOverlayState();
+			if (!statusPanelFbo_.isAllocated() || state != statusPanelState_) {
+				statusPanelState_ = state;
+				renderStatusPanel();
+				++overlayRenders_;
+			}
 		}
+		statusPanelFbo_.draw(x - OVERLAY_PADDING, y - OVERLAY_LINE_OFFSET);
 
-		// Print presets names
-		y = y + 5;
-		for (int i = 0; i < presetsNamesRemote.size(); i++) {
-			p = 15;
-			y = y + p;
-			string s = "";
-			if (i < 10) s += " ";
-			s += ofToString(i) + " ";
-			s += presetsNamesRemote[i];
-			if (i == selectedPresetIndexRemote) s += " *";
-			ofDrawBitmapStringHighlight(s, x, y);
+		// Per-frame cost of the overlays, label refreshed twice per second
+		if (now >= overlayCostLabelAt_) {
+			overlayCostLabelAt_ = now + OVERLAY_COST_LABEL_MS;
+			overlayCostLabel_ = "Overlay: " + ofToString(overlayCostMicros_ / 1000.0, 3) + " ms (" + ofToString(overlayRenders_) + " redraws)";
 		}
+		ofDrawBitmapStringHighlight(overlayCostLabel_, x, y - OVERLAY_LINE_OFFSET + statusPanelFbo_.getHeight() + 20);
 	}
 
 	//--
 
 	// Keys info
 	if (bKeys) {
-		p = 20;
+		if (!keysPanelFbo_.isAllocated()) {
+			renderKeysPanel();
+		}
 		x = ofGetWidth() - 200;
-		y = ofGetHeight() - 9 * p;
-		ofDrawBitmapStringHighlight("KEYS", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("G: Toggle Gui", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("D: Toggle Debug", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight(">: Next Preset", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("<: Previous Preset", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("L: Load", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("S: Save (Overwrite)", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("N: Save New", x, y);
-		y = y + p;
-		ofDrawBitmapStringHighlight("R: Refresh", x, y);
+		y = ofGetHeight() - 9 * 20;
+		keysPanelFbo_.draw(x - OVERLAY_PADDING, y - OVERLAY_LINE_OFFSET);
 	}
+
+	// Smoothed, so the label reads steady
+	double cost = static_cast<double>(ofGetElapsedTimeMicros() - timeStart);
+	overlayCostMicros_ = overlayCostMicros_ * 0.95 + cost * 0.05;
 }
 
 //--------------------------------------------------------------
-std::string ofxSurfingSupabase::generateTimestampName() {
-	std::time_t now = std::time(nullptr);
-	std::tm * tm = std::localtime(&now);
-
-	char buffer[64];
-	std::strftime(buffer, sizeof(buffer), "scene_%Y%m%d_%H%M%S", tm);
-
-	return std::string(buffer);
+ofxSurfingSupabase::OverlayState ofxSurfingSupabase::getOverlayState() {
+	clampPresetListScroll();
+
+	OverlayState state;
+	state.connected = bConnected;
+	state.loading = isLoadingRemote_.load();
+	state.saving = isSavingRemote_.load();
+	state.spinnerTick = (state.loading || state.saving) ? static_cast<int>(ofGetElapsedTimeMillis() / OVERLAY_REFRESH_MS % 4) : -1;
+	state.selected = selectedPresetIndexRemote.get();
+	state.scrollOffset = listScrollOffset_;
+	state.listRevision = presetListRevision_;
+	state.journalDepth = static_cast<int>(journal_.size());
+	state.journalRate = static_cast<int>(journalReplayRate_.load() * 10);
+	state.reachable = bRemoteReachable_.load();
+	state.localFirst = !bRemoteMode;
+	if (state.localFirst) {
+		uint64_t now = ofGetElapsedTimeMillis();
+		uint64_t oldest = journal_.getOldestTime();
+		state.lagPush = oldest == 0 ? 0 : static_cast<int>((now - oldest) / 1000);
+		state.lagPull = replicaPullTime_ == 0 ? -1 : static_cast<int>((now - replicaPullTime_) / 1000);
+	}
+	auto backend = getBackend();
+	if (backend) {
+		state.backendName = backend->getName();
+		state.backendLoad = static_cast<int>(backend->getStats(ofxSurfingSupabaseBackend::OP_LOAD).getAverageMillis() * 10);
+		state.backendSave = static_cast<int>(backend->getStats(ofxSurfingSupabaseBackend::OP_SAVE).getAverageMillis() * 10);
+		uint64_t bytesUp = 0;
+		uint64_t bytesDown = 0;
+		for (int i = 0; i < ofxSurfingSupabaseBackend::OP_COUNT; ++i) {
+			auto op = static_cast<ofxSurfingSupabaseBackend::Op>(i);
+			auto stats = backend->getStats(op);
+			state.backendRetries += static_cast<int>(stats.retries);
+			state.backendOpen = state.backendOpen || backend->isBreakerOpen(op);
+			state.backendRequests += static_cast<int>(stats.requests);
+			state.backendThrottled += static_cast<int>(stats.throttled);
+			bytesUp += stats.bytesSent;
+			bytesDown += stats.bytesReceived;
+		}
+		state.backendKbUp = static_cast<int>(bytesUp / 1024);
+		state.backendKbDown = static_cast<int>(bytesDown / 1024);
+		for (int i = 0; i < ofxSurfingSupabaseBackend::PRIORITY_COUNT; ++i) {
+			state.backendQueued += backend->getWaiting(static_cast<ofxSurfingSupabaseBackend::Priority>(i));
+		}
+	}
+	auto importProgress = getImportProgress();
+	if (importProgress.files > 0) {
+		state.importFiles = importProgress.files;
+		state.importDone = importProgress.uploaded + importProgress.invalid + importProgress.failed;
+		state.importRate = static_cast<int>(importProgress.getRate() * 10);
+	}
+	auto exportProgress = getExportProgress();
+	if (exportProgress.elapsedMs > 0) {
+		state.exportTotal = std::max(exportProgress.total, exportProgress.fetched);
+		state.exportDone = exportProgress.written + exportProgress.failed;
+		state.exportRate = static_cast<int>(exportProgress.getRate() * 10);
+	}
+	return state;
 }
 
 //--------------------------------------------------------------
-std::string ofxSurfingSupabase::serializeSceneToJson() {
-	if (!sceneParams_) {
-		ofLogError("ofxSurfingSupabase") << "Scene params not set";
-		return "{}";
+void ofxSurfingSupabase::renderStatusPanel() {
+	struct Line {
+		std::string text;
+		ofColor background;
+		ofColor foreground;
+		int spacing;
+	};
+	std::vector<Line> lines;
+
+	// Status
+	if (bConnected) {
+		lines.push_back({ "Status: CONNECTED", ofColor::black, ofColor::green, 20 });
+	} else {
+		lines.push_back({ "Status: DISCONNECTED", ofColor::black, ofColor::red, 20 });
 	}
 
-	ofJson json;
-	ofSerialize(json, *sceneParams_);
+	static const std::string spinner = "|/-\\";
+	if (statusPanelState_.loading) {
+		lines.push_back({ "Loading preset  " + std::string(1, spinner[statusPanelState_.spinnerTick]), ofColor::black, ofColor::yellow, 20 });
+	} else if (statusPanelState_.saving) {
+		lines.push_back({ "Saving preset   " + std::string(1, spinner[statusPanelState_.spinnerTick]), ofColor::black, ofColor::yellow, 20 });
+	} else {
+		lines.push_back({ "                 ", ofColor::black, ofColor::yellow, 20 });
+	}
 
-	return json.dump();
-}
+	// Write-ahead journal
+	std::string queue = "Queue: " + ofToString(statusPanelState_.journalDepth) + " pending, " + ofToString(statusPanelState_.journalRate / 10.0, 1) + " ops/s";
+	if (!statusPanelState_.reachable) queue += " OFFLINE";
+	lines.push_back({ queue, ofColor::black, statusPanelState_.reachable ? ofColor::white : ofColor::orange, 20 });
+
+	// Backend cost per call, the rest of a load or save is the addon's own
+	if (!statusPanelState_.backendName.empty()) {
+		std::string backend = "Backend: " + statusPanelState_.backendName;
+		backend += ", load " + ofToString(statusPanelState_.backendLoad / 10.0, 1) + " ms";
+		backend += ", save " + ofToString(statusPanelState_.backendSave / 10.0, 1) + " ms";
+		backend += ", " + ofToString(statusPanelState_.backendRetries) + " retries";
+		if (statusPanelState_.backendQueued > 0) backend += ", " + ofToString(statusPanelState_.backendQueued) + " queued";
+		if (statusPanelState_.backendOpen) backend += " CIRCUIT OPEN";
+		lines.push_back({ backend, ofColor::black, statusPanelState_.backendOpen ? ofColor::orange : ofColor::white, 20 });
+
+		// Request budget, what the project is billed and throttled on
+		if (statusPanelState_.backendRequests > 0) {
+			std::string budget = "Budget: " + ofToString(statusPanelState_.backendRequests) + " requests, ";
+			budget += ofToString(statusPanelState_.backendKbUp) + " KB up, " + ofToString(statusPanelState_.backendKbDown) + " KB down";
+			if (statusPanelState_.backendThrottled > 0) budget += ", " + ofToString(statusPanelState_.backendThrottled) + " throttled";
+			lines.push_back({ budget, ofColor::black, statusPanelState_.backendThrottled > 0 ? ofColor::orange : ofColor::white, 20 });
+		}
+	}
 
-//--------------------------------------------------------------
-void ofxSurfingSupabase::deserializeJsonToScene(const std::string & jsonStr) {
-	if (!sceneParams_) {
-		ofLogError("ofxSurfingSupabase") << "Scene params not set";
-		return;
+	// Bulk import, kept after it ends to show the outcome
+	if (statusPanelState_.importFiles > 0) {
+		std::string importLine = "Import: " + ofToString(statusPanelState_.importDone) + " / " + ofToString(statusPanelState_.importFiles);
+		importLine += ", " + ofToString(statusPanelState_.importRate / 10.0, 1) + " presets/s";
+		lines.push_back({ importLine, ofColor::black, statusPanelState_.importDone < statusPanelState_.importFiles ? ofColor::yellow : ofColor::white, 20 });
 	}
 
-	try {
-		ofJson json = ofJson::parse(jsonStr);
-		ofDeserialize(json, *sceneParams_);
-		ofLogNotice("ofxSurfingSupabase") << "Deserialized scene parameters";
-	} catch (std::exception & e) {
-		ofLogError("ofxSurfingSupabase") << "Failed to deserialize: " << e.what();
+	// Bulk export
+	if (statusPanelState_.exportTotal > 0) {
+		std::string exportLine = "Export: " + ofToString(statusPanelState_.exportDone) + " / " + ofToString(statusPanelState_.exportTotal);
+		exportLine += ", " + ofToString(statusPanelState_.exportRate / 10.0, 1) + " presets/s";
+		lines.push_back({ exportLine, ofColor::black, statusPanelState_.exportDone < statusPanelState_.exportTotal ? ofColor::yellow : ofColor::white, 20 });
 	}
-}
 
-//--------------------------------------------------------------
-void ofxSurfingSupabase::loadAndApplyRemote() {
-	ofLogNotice("ofxSurfingSupabase") << "loadAndApplyRemote()";
+	// Replication lag
+	if (statusPanelState_.localFirst) {
+		std::string lag = "Local-first: push lag " + ofToString(statusPanelState_.lagPush) + "s, pull lag ";
+		lag += statusPanelState_.lagPull < 0 ? "-" : ofToString(statusPanelState_.lagPull) + "s";
+		lines.push_back({ lag, ofColor::black, ofColor::white, 20 });
+	}
 
-	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+	// Selected
+	if (!presetsNamesRemote.empty() && selectedPresetIndexRemote >= 0 && selectedPresetIndexRemote < presetsNamesRemote.size()) {
+		std::string presetInfo = "Selected: " + presetsNamesRemote[selectedPresetIndexRemote.get()];
+		presetInfo += " (" + ofToString(selectedPresetIndexRemote.get()) + "/" + ofToString(presetsNamesRemote.size() - 1) + ")";
+		lines.push_back({ presetInfo, ofColor::black, ofColor::white, 20 });
+	}
+
+	// Print presets names.
+	// Virtualized: only the rows inside the scroll window are drawn.
+	int rowFirst = listScrollOffset_;
+	int rowLast = std::min(static_cast<int>(presetsNamesRemote.size()), rowFirst + LIST_ROWS_VISIBLE);
+	int digits = ofToString(std::max(0, static_cast<int>(presetsNamesRemote.size()) - 1)).size();
+
+	int spacing = 20; // 15 rows plus a 5px gap after the header lines
+	if (rowFirst > 0) {
+		lines.push_back({ "  ^ " + ofToString(rowFirst) + " more", ofColor::black, ofColor::white, spacing });
+		spacing = 15;
+	}
+	for (int i = rowFirst; i < rowLast; i++) {
+		string s = ofToString(i);
+		s = std::string(digits - s.size() + 1, ' ') + s + " ";
+		s += presetsNamesRemote[i].empty() ? "..." : presetsNamesRemote[i];
+		if (i == selectedPresetIndexRemote) s += " *";
+		lines.push_back({ s, ofColor::black, ofColor::white, spacing });
+		spacing = 15;
+	}
+	if (rowLast < static_cast<int>(presetsNamesRemote.size())) {
+		lines.push_back({ "  v " + ofToString(presetsNamesRemote.size() - rowLast) + " more", ofColor::black, ofColor::white, spacing });
+	}
+
+	// Size the fbo to the content, growing only
+	std::size_t chars = 0;
+	int height = OVERLAY_LINE_OFFSET + OVERLAY_PADDING;
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		chars = std::max(chars, lines[i].text.size());
+		if (i > 0) height += lines[i].spacing;
+	}
+	int width = static_cast<int>(chars) * 8 + 2 * OVERLAY_PADDING;
+
+	if (!statusPanelFbo_.isAllocated() || statusPanelFbo_.getWidth() < width || statusPanelFbo_.getHeight() < height) {
+		statusPanelFbo_.allocate(std::max(width, static_cast<int>(statusPanelFbo_.getWidth())), std::max(height, static_cast<int>(statusPanelFbo_.getHeight())), GL_RGBA);
+	}
+
+	statusPanelFbo_.begin();
+	ofClear(0, 0, 0, 0);
+	int y = OVERLAY_LINE_OFFSET;
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		if (i > 0) y += lines[i].spacing;
+		ofDrawBitmapStringHighlight(lines[i].text, OVERLAY_PADDING, y, lines[i].background, lines[i].foreground);
+	}
+	statusPanelFbo_.end();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::logBackendStats() {
+	auto backend = getBackend();
+	if (!backend) return;
+
+	ofLogNotice("ofxSurfingSupabase") << "Backend " << backend->getName() << " stats:";
+	for (int i = 0; i < ofxSurfingSupabaseBackend::OP_COUNT; ++i) {
+		auto op = static_cast<ofxSurfingSupabaseBackend::Op>(i);
+		auto stats = backend->getStats(op);
+		if (stats.calls == 0) continue;
+
+		ofLogNotice("ofxSurfingSupabase") << "  " << ofxSurfingSupabaseBackend::getOpName(op) << ": " << stats.calls << " calls, "
+										  << stats.failures << " failed, " << stats.retries << " retries, " << stats.rejected << " failed fast, "
+										  << stats.shared << " shared (" << ofToString(stats.getDedupRatio() * 100, 1) << "% dedup), "
+										  << stats.throttled << " throttled, " << stats.requests << " requests, "
+										  << stats.bytesSent << " bytes up, " << stats.bytesReceived << " bytes down, "
+										  << ofToString(stats.getAverageMillis(), 2) << " ms avg";
+	}
+
+	auto compression = backend->getCompressionStats();
+	if (compression.sentWire > 0 || compression.receivedWire > 0) {
+		ofLogNotice("ofxSurfingSupabase") << "  gzip: sent " << compression.sentRaw << " -> " << compression.sentWire << " bytes (" << ofToString(compression.getSentRatio(), 2) << "x), "
+										  << "received " << compression.receivedWire << " -> " << compression.receivedRaw << " bytes (" << ofToString(compression.getReceivedRatio(), 2) << "x), "
+										  << ofToString(compression.micros / 1000.0, 1) << " ms CPU";
+	}
+
+	auto tls = backend->getTlsStats();
+	if (tls.requests > 0) {
+		ofLogNotice("ofxSurfingSupabase") << "  tls: " << tls.requests << " requests, " << tls.fullHandshakes << " full handshakes ("
+										  << ofToString(tls.getFullMillis(), 1) << " ms avg), " << tls.resumedHandshakes << " resumed, "
+										  << ofToString(tls.getSavedMillisPerRequest(), 1) << " ms saved per request";
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabase::exportBackendStats(const std::string & path) {
+	auto backend = getBackend();
+	if (!backend) return false;
+
+	ofJson json;
+	json["backend"] = backend->getName();
+	json["exported_at"] = ofxSurfingSupabaseBackend::makeTimestamp();
+
+	ofJson ops = ofJson::object();
+	for (int i = 0; i < ofxSurfingSupabaseBackend::OP_COUNT; ++i) {
+		auto op = static_cast<ofxSurfingSupabaseBackend::Op>(i);
+		auto stats = backend->getStats(op);
+		ofJson entry;
+		entry["calls"] = stats.calls;
+		entry["failures"] = stats.failures;
+		entry["retries"] = stats.retries;
+		entry["rejected"] = stats.rejected;
+		entry["shared"] = stats.shared;
+		entry["throttled"] = stats.throttled;
+		entry["requests"] = stats.requests;
+		entry["bytes_sent"] = stats.bytesSent;
+		entry["bytes_received"] = stats.bytesReceived;
+		entry["average_ms"] = stats.getAverageMillis();
+		ops[ofxSurfingSupabaseBackend::getOpName(op)] = entry;
+	}
+	json["ops"] = ops;
+
+	json["budget"]["reads"] = backend->getRateBudget(false);
+	json["budget"]["writes"] = backend->getRateBudget(true);
+
+	auto compression = backend->getCompressionStats();
+	json["gzip"]["sent_raw"] = compression.sentRaw;
+	json["gzip"]["sent_wire"] = compression.sentWire;
+	json["gzip"]["received_raw"] = compression.receivedRaw;
+	json["gzip"]["received_wire"] = compression.receivedWire;
+
+	auto tls = backend->getTlsStats();
+	json["tls"]["requests"] = tls.requests;
+	json["tls"]["full_handshakes"] = tls.fullHandshakes;
+	json["tls"]["resumed_handshakes"] = tls.resumedHandshakes;
+
+	if (!ofSavePrettyJson(path, json)) {
+		ofLogError("ofxSurfingSupabase") << "exportBackendStats(): ✗ Failed to write " << path;
+		return false;
+	}
+	ofLogNotice("ofxSurfingSupabase") << "exportBackendStats(): ✓ " << path;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::renderKeysPanel() {
+	static const std::vector<std::string> lines = {
+		"KEYS",
+		"G: Toggle Gui",
+		"D: Toggle Debug",
+		">: Next Preset",
+		"<: Previous Preset",
+		"L: Load",
+		"S: Save (Overwrite)",
+		"N: Save New",
+		"R: Refresh"
+	};
+
+	int p = 20;
+	keysPanelFbo_.allocate(200, static_cast<int>(lines.size()) * p + OVERLAY_PADDING, GL_RGBA);
+
+	keysPanelFbo_.begin();
+	ofClear(0, 0, 0, 0);
+	int y = OVERLAY_LINE_OFFSET;
+	for (auto & line : lines) {
+		ofDrawBitmapStringHighlight(line, OVERLAY_PADDING, y);
+		y = y + p;
+	}
+	keysPanelFbo_.end();
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::generateTimestampName() {
+	std::time_t now = std::time(nullptr);
+	std::tm * tm = std::localtime(&now);
+
+	char buffer[64];
+	std::strftime(buffer, sizeof(buffer), "scene_%Y%m%d_%H%M%S", tm);
+
+	return std::string(buffer);
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::makeUniqueName(const std::string & baseName, const std::unordered_set<std::string> & takenNames) {
+	if (takenNames.count(baseName) == 0) return baseName;
+
+	for (int i = 1;; ++i) {
+		std::string name = baseName + "_" + ofToString(i);
+		if (takenNames.count(name) == 0) return name;
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabase::isNewerTimestamp(const std::string & a, const std::string & b) {
+	// UTC ISO 8601 strings order lexicographically, also with trimmed fractions:
+	// '+' sorts before '.' and the digits. Empty means never stamped.
+	return a > b;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::serializeSceneToJson() {
+	if (!sceneParams_) {
+		ofLogError("ofxSurfingSupabase") << "Scene params not set";
+		return "{}";
+	}
+
+	ofJson json;
+	ofSerialize(json, *sceneParams_);
+
+	return json.dump();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::deserializeJsonToScene(const std::string & jsonStr) {
+	if (!sceneParams_) {
+		ofLogError("ofxSurfingSupabase") << "Scene params not set";
 		return;
 	}
 
+	try {
+		ofJson json = ofJson::parse(jsonStr);
+		ofDeserialize(json, *sceneParams_);
+		ofLogNotice("ofxSurfingSupabase") << "Deserialized scene parameters";
+	} catch (std::exception & e) {
+		ofLogError("ofxSurfingSupabase") << "Failed to deserialize: " << e.what();
+	}
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::loadAndApplyRemote() {
+	ofLogNotice("ofxSurfingSupabase") << "loadAndApplyRemote()";
+
 	if (selectedPresetIndexRemote < 0 || selectedPresetIndexRemote >= presetsNamesRemote.size()) {
 		ofLogWarning("ofxSurfingSupabase") << "No preset selected";
 		return;
 	}
 
-	loadPreset(presetsNamesRemote[selectedPresetIndexRemote.get()]);
+	std::string name = getSelectedPresetName();
+	if (name.empty()) {
+		// Page not loaded yet: update() loads it as soon as the name arrives
+		bAutoLoadDeferred_ = true;
+		return;
+	}
+
+	loadPreset(name);
 }
 
 //--------------------------------------------------------------
 void ofxSurfingSupabase::savePreset(const std::string & presetName) {
 	ofLogNotice("ofxSurfingSupabase") << "savePreset(): " << presetName;
 
-	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+	std::string userId = getJournalUserId();
+	if (userId.empty()) {
+		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+		return;
+	}
+
+	std::string jsonData = serializeSceneToJson();
+
+	// Remote mode: sent at once, unless local-first left entries to drain, which go first
+	if (bRemoteMode && journal_.size() == 0) {
+		ofxSurfingSupabaseJournal::Entry entry;
+		entry.op = ofxSurfingSupabaseJournal::OP_SAVE;
+		entry.userId = userId;
+		entry.name = presetName;
+		entry.payload = jsonData;
+		writeRemote(entry);
+		return;
+	}
+
+	// Local store first, unstamped: pending, it wins over pulled remote rows
+	// until the remote acknowledges it with its own updated_at (no client clocks compared).
+	// Then the journal: the save survives a dropped network or a crash,
+	// the journal worker sends it as soon as the remote is reachable.
+	cache_.put(presetName, jsonData, "");
+	if (findPresetIndex(presetName) < 0) presetNamesUnpushed_.insert(presetName);
+	patchPresetNameAdded(presetName);
+
+	journal_.append(ofxSurfingSupabaseJournal::OP_SAVE, userId, presetName, jsonData);
+	journalCondition_.notify_one();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::savePresetNew(const std::string & presetName) {
+	ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): " << presetName;
+
+	std::string userId = getJournalUserId();
+	if (userId.empty()) {
+		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+		return;
+	}
+
+	std::string baseName = presetName.empty() ? generateTimestampName() : presetName;
+	std::string jsonData = serializeSceneToJson();
+
+	// Resolve the unique name against the cached list and the saves still queued,
+	// so the common case is a single POST. Conflicts are resolved again on replay.
+	std::unordered_set<std::string> takenNames;
+	takenNames.reserve(presetIndexByName_.size());
+	for (auto & item : presetIndexByName_) {
+		takenNames.insert(item.first);
+	}
+	for (auto & name : journal_.getPendingNames()) {
+		takenNames.insert(name);
+	}
+	std::string name = makeUniqueName(baseName, takenNames);
+
+	if (bRemoteMode && journal_.size() == 0) {
+		ofxSurfingSupabaseJournal::Entry entry;
+		entry.seq = ofGetSystemTimeMillis(); // Unique enough for the last-round name
+		entry.op = ofxSurfingSupabaseJournal::OP_SAVE_NEW;
+		entry.userId = userId;
+		entry.name = name;
+		entry.payload = jsonData;
+		writeRemote(entry);
+		return;
+	}
+
+	cache_.put(name, jsonData, "");
+	presetNamesUnpushed_.insert(name);
+	patchPresetNameAdded(name);
+
+	journal_.append(ofxSurfingSupabaseJournal::OP_SAVE_NEW, userId, name, jsonData);
+	journalCondition_.notify_one();
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::getJournalUserId() const {
+	// Offline after a warm start the session user is not known yet, the cached owner is
+	return userId_.empty() ? listUserId_ : userId_;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::setJournalSession(bool connected) {
+	// userId_ and bConnected belong to the main thread, the worker gets a copy
+	{
+		std::lock_guard<std::mutex> lock(journalMutex_);
+		journalUserId_ = connected ? userId_ : "";
+	}
+	journalConnected_ = connected;
+	journalCondition_.notify_one();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::journalThreadFunction() {
+	ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_SAVE);
+	uint64_t retryAt = 0;
+	uint64_t backoffMs = 0;
+
+	while (journalThreadRunning_) {
+		std::string userId;
+		{
+			std::unique_lock<std::mutex> lock(journalMutex_);
+			journalCondition_.wait_for(lock, std::chrono::milliseconds(static_cast<int64_t>(JOURNAL_SYNC_MS)));
+			userId = journalUserId_;
+		}
+		if (!journalThreadRunning_) break;
+
+		// Group commit: every append since the last pass shares one fsync
+		journal_.sync();
+
+		if (!journalConnected_ || userId.empty() || ofGetElapsedTimeMillis() < retryAt) continue;
+
+		uint64_t timeStart = ofGetElapsedTimeMillis();
+		int replayed = 0;
+		ofxSurfingSupabaseJournal::Entry entry;
+
+		// Strictly in order: a failing entry blocks the ones behind it
+		while (journalThreadRunning_ && journalConnected_ && journal_.front(entry)) {
+			std::size_t count = 1;
+			ReplayResult result;
+			if (entry.op == ofxSurfingSupabaseJournal::OP_DELETE) {
+				result = replayJournalDeletes(userId, count);
+			} else if (entry.op == ofxSurfingSupabaseJournal::OP_CLEAR) {
+				result = replayJournalClear(entry, userId);
+			} else {
+				result = replayJournalEntry(entry, userId);
+			}
+
+			if (result == REPLAY_RETRY) {
+				backoffMs = backoffMs == 0 ? JOURNAL_RETRY_MIN_MS : std::min<uint64_t>(backoffMs * 2, JOURNAL_RETRY_MAX_MS);
+				retryAt = ofGetElapsedTimeMillis() + backoffMs;
+				bRemoteReachable_ = false;
+				ofLogWarning("ofxSurfingSupabase") << "journal: Remote unreachable, retry in " << backoffMs << " ms (" << journal_.size() << " pending)";
+				break;
+			}
+
+			journal_.pop(count);
+			replayed += static_cast<int>(count);
+			backoffMs = 0;
+			bRemoteReachable_ = true;
+		}
+
+		journal_.sync();
+
+		if (replayed > 0) {
+			double seconds = std::max(0.001, (ofGetElapsedTimeMillis() - timeStart) / 1000.0);
+			journalReplayRate_ = replayed / seconds;
+			journalReplayed_ += replayed;
+			if (bDebug) {
+				ofLogNotice("ofxSurfingSupabase") << "journal: ✓ Replayed " << replayed << " entries (" << ofToString(journalReplayRate_.load(), 1) << " ops/s)";
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::replayJournalEntry(const ofxSurfingSupabaseJournal::Entry & entry, const std::string & userId) {
+	if (entry.userId != userId) {
+		ofLogWarning("ofxSurfingSupabase") << "journal: Dropped entry of another user: " << entry.name;
+		return REPLAY_DONE;
+	}
+
+	auto backend = getBackend();
+	if (!backend) return REPLAY_RETRY;
+
+	ofJson presetJson;
+	try {
+		presetJson = ofJson::parse(entry.payload);
+	} catch (std::exception & e) {
+		ofLogError("ofxSurfingSupabase") << "journal: Dropped invalid JSON for " << entry.name << ": " << e.what();
+		return REPLAY_DONE;
+	}
+
+	// Superseded by a later local save or by a newer remote version pulled meanwhile
+	ofxSurfingSupabaseCache::Info info;
+	if (cache_.getInfo(entry.name, info) && info.hash != ofxSurfingSupabaseCache::hashPayload(entry.payload)) {
+		if (bDebug) {
+			ofLogNotice("ofxSurfingSupabase") << "journal: Skipped superseded save of " << entry.name;
+		}
+		return REPLAY_DONE;
+	}
+
+	isSavingRemote_ = true;
+	ReplayResult result = (entry.op == ofxSurfingSupabaseJournal::OP_SAVE_NEW)
+		? replaySavePresetNew(*backend, entry, presetJson)
+		: replaySavePreset(*backend, entry);
+	isSavingRemote_ = false;
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::replayJournalDeletes(const std::string & userId, std::size_t & count) {
+	std::vector<ofxSurfingSupabaseJournal::Entry> entries;
+	journal_.front(entries, JOURNAL_DELETE_BATCH);
+
+	// Only up to the next save: replay order is kept
+	std::vector<std::string> names;
+	for (auto & entry : entries) {
+		if (entry.op != ofxSurfingSupabaseJournal::OP_DELETE || entry.userId != entries.front().userId) break;
+		names.push_back(entry.name);
+	}
+	count = names.size();
+
+	if (entries.front().userId != userId) {
+		ofLogWarning("ofxSurfingSupabase") << "journal: Dropped " << count << " deletes of another user";
+		return REPLAY_DONE;
+	}
+
+	auto backend = getBackend();
+	if (!backend) return REPLAY_RETRY;
+
+	auto res = backend->removeBulk(names);
+
+	if (res.success) {
+		ofLogNotice("ofxSurfingSupabase") << "deletePresetsRemote(): ✓ " << count << " presets deleted successfully";
+		hasPendingRefresh_ = true; // Confirms the patched list with a probe
+		return REPLAY_DONE;
+	}
+
+	ofLogError("ofxSurfingSupabase") << "deletePresetsRemote(): ✗ Failed to delete " << count << " presets: HTTP " << res.status;
+	if (bDebug) {
+		ofLogError("ofxSurfingSupabase") << res.error;
+	}
+	ReplayResult result = getReplayResult(res.status);
+
+	// Rejected for good: the presets are still there, the probe finds the list diverged
+	if (result == REPLAY_DONE) hasPendingRefresh_ = true;
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::replayJournalClear(const ofxSurfingSupabaseJournal::Entry & entry, const std::string & userId) {
+	if (entry.userId != userId) {
+		ofLogWarning("ofxSurfingSupabase") << "journal: Dropped wipe of another user";
+		return REPLAY_DONE;
+	}
+
+	auto backend = getBackend();
+	if (!backend) return REPLAY_RETRY;
+
+	auto res = backend->removeAll();
+
+	if (res.success) {
+		// Drop the cached copies now, before the saves queued behind the wipe land;
+		// those keep theirs so their replay is not taken as superseded
+		std::vector<ofxSurfingSupabaseJournal::Entry> entries;
+		journal_.front(entries, journal_.size());
+		cache_.clear();
+		for (auto & pending : entries) {
+			if (pending.seq <= entry.seq || pending.op == ofxSurfingSupabaseJournal::OP_DELETE) continue;
+			if (pending.op == ofxSurfingSupabaseJournal::OP_CLEAR) break;
+			cache_.put(pending.name, pending.payload, "");
+		}
+
+		// Saves confirmed before the wipe must not patch the emptied list
+		std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+		pendingPresetNamesAdded_.clear();
+		hasPendingPresetNamesAdded_ = false;
+		hasPendingClear_ = true;
+		return REPLAY_DONE;
+	}
+
+	ofLogError("ofxSurfingSupabase") << "clearDatabase(): ✗ Failed to clear database: HTTP " << res.status;
+	if (bDebug) {
+		ofLogError("ofxSurfingSupabase") << res.error;
+	}
+	return getReplayResult(res.status);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::replaySavePreset(ofxSurfingSupabaseBackend & backend, const ofxSurfingSupabaseJournal::Entry & entry) {
+	if (bDebug) {
+		ofLogNotice("ofxSurfingSupabase") << "savePreset(): Preset name: " << entry.name;
+	}
+
+	// Upsert: replaying an entry that already reached the server is harmless
+	ofxSurfingSupabaseBackend::Row row { entry.name, "", entry.payload };
+	ofxSurfingSupabaseBackend::Row saved;
+	auto res = backend.save(row, true, saved);
+
+	if (res.success) {
+		ofLogNotice("ofxSurfingSupabase") << "savePreset(): ✓ Preset saved successfully";
+		onPresetSaved(saved, entry.payload);
+		return REPLAY_DONE;
+	}
+
+	ofLogError("ofxSurfingSupabase") << "savePreset(): ✗ Failed to save preset: HTTP " << res.status;
+	if (bDebug) {
+		ofLogError("ofxSurfingSupabase") << res.error;
+	}
+	ReplayResult result = getReplayResult(res.status);
+	if (result == REPLAY_DONE) onPresetSaveDropped(entry);
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::replaySavePresetNew(ofxSurfingSupabaseBackend & backend, const ofxSurfingSupabaseJournal::Entry & entry, const ofJson & presetJson) {
+	std::unordered_set<std::string> takenNames;
+	std::string name = entry.name;
+	uint64_t timeStart = ofGetElapsedTimeMillis();
+	int requests = 0;
+
+	for (int round = 0; round < UNIQUE_NAME_ROUNDS_MAX; ++round) {
+		ofxSurfingSupabaseBackend::Row row { name, "", entry.payload };
+		ofxSurfingSupabaseBackend::Row saved;
+		auto res = backend.save(row, false, saved);
+		++requests;
+
+		if (res.success) {
+			ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): ✓ Preset saved as: " << name;
+			if (bDebug) {
+				ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): " << requests << " request(s) in " << (ofGetElapsedTimeMillis() - timeStart) << " ms";
+			}
+			if (name != entry.name) {
+				cache_.erase(entry.name); // That name belongs to another preset
+			}
+			onPresetSaved(saved, entry.payload);
+			return REPLAY_DONE;
+		}
+
+		if (res.status != 409) {
+			ofLogError("ofxSurfingSupabase") << "savePresetNew(): ✗ Failed to save preset: HTTP " << res.status;
+			if (bDebug) {
+				ofLogError("ofxSurfingSupabase") << res.error;
+			}
+			ReplayResult result = getReplayResult(res.status);
+			if (result == REPLAY_DONE) onPresetSaveDropped(entry);
+			return result;
+		}
+
+		// A replay after a lost response finds its own row: nothing left to do
+		if (round == 0) {
+			ofxSurfingSupabaseBackend::Row existing;
+			auto rowRes = backend.load(name, "", existing);
+			++requests;
+
+			try {
+				if (rowRes.success && !existing.name.empty() && ofJson::parse(existing.payload) == presetJson) {
+					ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): ✓ Already saved as: " << name;
+					onPresetSaved(existing, entry.payload);
+					return REPLAY_DONE;
+				}
+			} catch (std::exception &) {
+			}
+		}
+
+		// Our cached list was stale (another client saved meanwhile).
+		// Fetch only the names sharing the base prefix and resolve again.
+		takenNames.insert(name);
+
+		ofxSurfingSupabaseBackend::Query query;
+		query.namePrefix = entry.name;
+		std::vector<ofxSurfingSupabaseBackend::Row> rows;
+		int total;
+		auto likeRes = backend.list(query, rows, total);
+		++requests;
+
+		if (likeRes.success) {
+			for (auto & item : rows) {
+				takenNames.insert(item.name);
+			}
+		} else {
+			ofLogWarning("ofxSurfingSupabase") << "savePresetNew(): Failed to fetch taken names: HTTP " << likeRes.status;
+		}
+
+		// Last round: the journal seq is unique to this save, so only a name taken
+		// between our listing and the insert can still collide
+		if (round + 2 == UNIQUE_NAME_ROUNDS_MAX) {
+			name = makeUniqueName(entry.name + "_" + ofToString(entry.seq), takenNames);
+		} else {
+			name = makeUniqueName(entry.name, takenNames);
+		}
+	}
+
+	ofLogError("ofxSurfingSupabase") << "savePresetNew(): ✗ Failed to find unique name, preset not saved: " << entry.name;
+	onPresetSaveDropped(entry);
+	return REPLAY_DONE;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::onPresetSaveDropped(const ofxSurfingSupabaseJournal::Entry & entry) {
+	// Called from the journal worker: the save is gone, so is its local copy,
+	// unless a later save of the same name replaced it meanwhile
+	ofxSurfingSupabaseCache::Info info;
+	if (!cache_.getInfo(entry.name, info) || info.hash != ofxSurfingSupabaseCache::hashPayload(entry.payload)) return;
+
+	cache_.erase(entry.name);
+
+	std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+	pendingPresetNamesDropped_.push_back(entry.name);
+	hasPendingPresetNamesDropped_ = true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabase::writeRemote(const ofxSurfingSupabaseJournal::Entry & entry, const std::vector<std::string> & names) {
+	// Remote mode: the journal's replay steps without the journal. One write at a time
+	// keeps them in order. Nothing is stored locally, so a failed write is reported, not retried.
+	auto backend = getBackend();
+	if (!bConnected || !backend) {
+		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+		return false;
+	}
+
+	if (isSavingRemote_.exchange(true)) {
+		ofLogWarning("ofxSurfingSupabase") << "Save already in progress";
+		return false;
+	}
+
+	std::thread([this, backend, entry, names]() {
+		ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_SAVE);
+
+		if (entry.op == ofxSurfingSupabaseJournal::OP_SAVE) {
+			replaySavePreset(*backend, entry);
+		} else if (entry.op == ofxSurfingSupabaseJournal::OP_SAVE_NEW) {
+			replaySavePresetNew(*backend, entry, ofJson::parse(entry.payload));
+		} else if (entry.op == ofxSurfingSupabaseJournal::OP_DELETE) {
+			auto res = backend->removeBulk(names);
+			if (res.success) {
+				ofLogNotice("ofxSurfingSupabase") << "deletePresetsRemote(): ✓ " << names.size() << " presets deleted successfully";
+			} else {
+				ofLogError("ofxSurfingSupabase") << "deletePresetsRemote(): ✗ Failed to delete " << names.size() << " presets: HTTP " << res.status;
+				if (bDebug) {
+					ofLogError("ofxSurfingSupabase") << res.error;
+				}
+			}
+			hasPendingRefresh_ = true; // Confirms the patched list, or restores it
+		} else if (entry.op == ofxSurfingSupabaseJournal::OP_CLEAR) {
+			replayJournalClear(entry, entry.userId);
+		}
+
+		isSavingRemote_ = false;
+	}).detach();
+	return true;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabase::ReplayResult ofxSurfingSupabase::getReplayResult(int statusCode) {
+	// Network down, throttled, server trouble or an expired token: keep the entry.
+	// Anything else is a permanent rejection that would block the queue forever.
+	if (statusCode == 0 || statusCode == 401 || statusCode == 408 || statusCode == 429 || statusCode >= 500) {
+		return REPLAY_RETRY;
+	}
+
+	ofLogError("ofxSurfingSupabase") << "journal: Dropped entry rejected with HTTP " << statusCode;
+	return REPLAY_DONE;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::startReplicaPull() {
+	isReplicatingRemote_ = true;
+	replicaPullAt_ = ofGetElapsedTimeMillis() + REPLICA_PULL_INTERVAL_MS;
+
+	std::string userId = userId_;
+	std::string watermark = replicaWatermark_;
+
+	std::thread([this, userId, watermark]() {
+		ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_REPLICATION);
+		ReplicaPull pull;
+		pull.userId = userId;
+		pull.watermark = watermark;
+		pullReplicaRemote(pull);
+
+		std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+		pendingReplicaPull_ = std::move(pull);
+		hasPendingReplicaPull_ = true;
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::pullReplicaRemote(ReplicaPull & pull) {
+	auto backend = getBackend();
+	if (!backend) return;
+
+	// Rows changed since the last pull, oldest first, with their data
+	ofxSurfingSupabaseBackend::Query query;
+	query.withData = true;
+	query.byUpdated = true;
+	query.limit = REPLICA_BATCH_SIZE;
+
+	for (;;) {
+		query.updatedAfter = pull.watermark;
+
+		std::vector<ofxSurfingSupabaseBackend::Row> rows;
+		int total;
+		auto res = backend->list(query, rows, total);
+		if (!res.success) {
+			ofLogWarning("ofxSurfingSupabase") << "pullReplicaRemote(): ✗ Failed to pull: HTTP " << res.status;
+			return;
+		}
+
+		for (auto & row : rows) {
+			if (isNewerTimestamp(row.updatedAt, pull.watermark)) {
+				pull.watermark = row.updatedAt;
+			}
+
+			// Last writer wins by the server's updated_at.
+			// A pending local save (unstamped) stays, the journal pushes it.
+			ofxSurfingSupabaseCache::Info info;
+			bool cached = cache_.getInfo(row.name, info);
+			if (cached && (info.updatedAt.empty() || !isNewerTimestamp(row.updatedAt, info.updatedAt))) {
+				++pull.skipped;
+				continue;
+			}
+
+			cache_.put(row.name, row.payload, row.updatedAt);
+			pull.names.push_back(row.name);
+			if (!cached || ofxSurfingSupabaseCache::hashPayload(row.payload) != info.hash) {
+				pull.changed.push_back(row.name);
+			}
+		}
+
+		if (static_cast<int>(rows.size()) < REPLICA_BATCH_SIZE) break;
+	}
+
+	pull.success = true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::applyReplicaPull(const ReplicaPull & pull) {
+	if (!pull.success || pull.userId != userId_) return; // Failed, or the session changed meanwhile
+
+	replicaPullTime_ = ofGetElapsedTimeMillis();
+	if (pull.watermark != replicaWatermark_) {
+		replicaWatermark_ = pull.watermark;
+		cacheStateRevision_ = -1; // Persist with the next state save
+	}
+
+	if (pull.names.empty()) return;
+
+	ofLogNotice("ofxSurfingSupabase") << "applyReplicaPull(): ✓ Pulled " << pull.names.size() << " presets, " << pull.skipped << " kept local";
+
+	// A partially paged list can't be patched in place
+	if (isPresetListComplete()) {
+		for (auto & name : pull.names) {
+			patchPresetNameAdded(name);
+		}
+	} else {
+		refreshPresetListRemote();
+	}
+
+	// The local store now holds other content for the selected preset
+	if (bAutoLoad && !selectedPresetName_.empty()
+		&& std::find(pull.changed.begin(), pull.changed.end(), selectedPresetName_) != pull.changed.end()) {
+		loadAndApplyRemote();
+	}
+}
+
+//--------------------------------------------------------------
+uint64_t ofxSurfingSupabase::getReplicationLagMillis() {
+	uint64_t now = ofGetElapsedTimeMillis();
+	uint64_t oldest = journal_.getOldestTime();
+	uint64_t lag = oldest == 0 ? 0 : now - oldest;
+
+	if (!bRemoteMode && replicaPullTime_ != 0) {
+		lag = std::max(lag, now - replicaPullTime_);
+	}
+	return lag;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::loadPreset(const std::string & presetName) {
+	ofLogNotice("ofxSurfingSupabase") << "loadPreset(): " << presetName;
+
+	// Local-first: serve from the disk cache at once. Remote mode reads the remote,
+	// only a local save still queued from local-first is newer than the remote copy.
+	std::string cachedData;
+	ofxSurfingSupabaseCache::Info cachedInfo;
+	bool cached = cache_.get(presetName, cachedData, cachedInfo);
+
+	// Local-first: the local store is authoritative, the replicator keeps it current
+	if (cached && (!bRemoteMode || cachedInfo.updatedAt.empty())) {
+		std::lock_guard<std::mutex> lock(pendingPresetMutex_);
+		pendingPresetJson_ = cachedData;
+		pendingPresetName_ = presetName;
+		hasPendingPreset_ = true;
+		return;
+	}
+
+	auto backend = getBackend();
+	if (!bConnected || !backend) {
+		ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Not connected";
+		return;
+	}
+
+	if (isLoadingRemote_.exchange(true)) {
+		ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Load already in progress";
+		return;
+	}
+
+	std::string presetNameCopy = presetName;
+	bool store = !bRemoteMode; // Local-first fills its store, remote mode keeps nothing
+
+	backend->loadAsync(presetName, "", [this, presetNameCopy, store](const ofxSurfingSupabaseBackend::Result & res, const ofxSurfingSupabaseBackend::Row & row) {
+		if (res.success) {
+			if (!row.name.empty()) {
+				// Saved locally while the request was in flight: the pending copy wins
+				ofxSurfingSupabaseCache::Info info;
+				bool pending = cache_.getInfo(presetNameCopy, info) && info.updatedAt.empty();
+
+				if (!pending) {
+					if (store) cache_.put(presetNameCopy, row.payload, row.updatedAt);
+					std::lock_guard<std::mutex> lock(pendingPresetMutex_);
+					pendingPresetJson_ = row.payload;
+					pendingPresetName_ = presetNameCopy;
+					hasPendingPreset_ = true;
+				}
+			} else {
+				ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Preset not found";
+			}
+		} else {
+			ofLogError("ofxSurfingSupabase") << "loadPreset(): ✗ Failed to load preset: HTTP " << res.status;
+			if (bDebug) {
+				ofLogError("ofxSurfingSupabase") << res.error;
+			}
+		}
+
+		isLoadingRemote_ = false;
+	});
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::loadPresets(const std::vector<std::string> & presetNames, ofxSurfingSupabaseBackend::Priority priority) {
+	ofLogNotice("ofxSurfingSupabase") << "loadPresets(): " << presetNames.size() << " presets";
+
+	// Remote mode reads every preset from the remote, there is no store to fill
+	if (bRemoteMode) {
+		ofLogNotice("ofxSurfingSupabase") << "loadPresets(): Remote Mode keeps no local copies, skipped";
+		return;
+	}
+
+	// Local-first: cached presets are authoritative, only fetch the missing ones
+	std::vector<std::string> names;
+	std::unordered_set<std::string> seen;
+	for (auto & name : presetNames) {
+		if (!seen.insert(name).second) continue;
+		ofxSurfingSupabaseCache::Info info;
+		if (cache_.getInfo(name, info)) continue;
+		names.push_back(name);
+	}
+	if (names.empty()) return;
+
+	auto backend = getBackend();
+	if (!bConnected || !backend) {
+		ofLogWarning("ofxSurfingSupabase") << "loadPresets(): Not connected";
+		return;
+	}
+
+	auto timeStart = ofGetElapsedTimeMillis();
+	std::size_t requested = names.size();
+
+	backend->loadBulkAsync(names, [this, requested, timeStart](const ofxSurfingSupabaseBackend::Result & res, const std::vector<ofxSurfingSupabaseBackend::Row> & rows) {
+		// Rows of the chunks done before a failure are kept
+		int updated = 0;
+		for (auto & row : rows) {
+			ofxSurfingSupabaseCache::Info info;
+			if (cache_.getInfo(row.name, info) && (info.updatedAt.empty() || ofxSurfingSupabaseCache::hashPayload(row.payload) == info.hash)) continue;
+			cache_.put(row.name, row.payload, row.updatedAt);
+			updated++;
+		}
+
+		if (res.success) {
+			ofLogNotice("ofxSurfingSupabase") << "loadPresets(): ✓ " << rows.size() << " of " << requested << " found, "
+											  << updated << " updated in cache, " << (ofGetElapsedTimeMillis() - timeStart) << " ms";
+		} else {
+			ofLogError("ofxSurfingSupabase") << "loadPresets(): ✗ Failed after " << rows.size() << " of " << requested << ": HTTP " << res.status;
+			if (bDebug) {
+				ofLogError("ofxSurfingSupabase") << res.error;
+			}
+		}
+	}, priority);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::importFolder(const std::string & folder, int batchSize) {
+	ofLogNotice("ofxSurfingSupabase") << "importFolder(): " << folder;
+
+	if (!sceneParams_) {
+		ofLogError("ofxSurfingSupabase") << "importFolder(): Scene params not set";
 		return;
 	}
-
-	if (isSavingRemote_.exchange(true)) {
-		ofLogWarning("ofxSurfingSupabase") << "savePreset(): Save already in progress";
+	if (!bConnected || !getBackend()) {
+		ofLogWarning("ofxSurfingSupabase") << "importFolder(): Not connected";
+		return;
+	}
+	if (isImporting_.exchange(true)) {
+		ofLogWarning("ofxSurfingSupabase") << "importFolder(): Import already in progress";
 		return;
 	}
 
-	std::string presetNameCopy = presetName;
-	std::string jsonData = serializeSceneToJson();
+	std::vector<std::string> paths;
+	std::error_code ec;
+	for (auto & item : std::filesystem::directory_iterator(ofToDataPath(folder, true), ec)) {
+		if (item.is_regular_file() && ofToLower(item.path().extension().string()) == ".json") {
+			paths.push_back(item.path().string());
+		}
+	}
+	if (ec) {
+		ofLogError("ofxSurfingSupabase") << "importFolder(): ✗ Can't list " << folder << ": " << ec.message();
+		isImporting_ = false;
+		return;
+	}
+	std::sort(paths.begin(), paths.end());
+
+	// The shape every file must have, taken now: the scene may change meanwhile
+	ofJson shape;
+	ofSerialize(shape, *sceneParams_);
+
+	importFiles_ = static_cast<int>(paths.size());
+	importRead_ = 0;
+	importInvalid_ = 0;
+	importUploaded_ = 0;
+	importFailed_ = 0;
+	importBytes_ = 0;
+	importTimeStart_ = ofGetElapsedTimeMillis();
+	importTimeEnd_ = 0;
+
+	std::thread([this, paths, shape, batchSize]() {
+		ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_SAVE);
+		importFolderThread(paths, shape, std::max(1, batchSize));
+		importTimeEnd_ = ofGetElapsedTimeMillis();
+		isImporting_ = false;
+
+		auto progress = getImportProgress();
+		double seconds = std::max(0.001, progress.elapsedMs / 1000.0);
+		ofLogNotice("ofxSurfingSupabase") << "importFolder(): ✓ " << progress.uploaded << " of " << progress.files << " imported, "
+										  << progress.invalid << " invalid, " << progress.failed << " failed, "
+										  << ofToString(seconds, 1) << " s (" << ofToString(progress.getRate(), 1) << " presets/s, "
+										  << ofToString(progress.bytes / 1048576.0 / seconds, 2) << " MB/s read)";
+	}).detach();
+}
 
-	std::thread([this, presetNameCopy, jsonData]() {
-		ofJson presetJson;
+//--------------------------------------------------------------
+void ofxSurfingSupabase::importFolderThread(const std::vector<std::string> & paths, const ofJson & shape, int batchSize) {
+	auto backend = getBackend();
+	if (!backend) return;
+
+	// Readers parse and validate in parallel into a bounded queue, this thread uploads it in batches
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::deque<ofxSurfingSupabaseBackend::Row> queue;
+	std::unordered_set<std::string> names;
+	std::size_t queueMax = static_cast<std::size_t>(batchSize) * IMPORT_QUEUE_BATCHES;
+	std::atomic<std::size_t> next { 0 };
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	int readersRunning = std::min(static_cast<int>(paths.size()), ofClamp(cores, 2, static_cast<int>(IMPORT_READERS_MAX)));
+
+	auto reader = [&]() {
+		for (std::size_t i = next++; i < paths.size(); i = next++) {
+			const std::string & path = paths[i];
+			std::ifstream file(path, std::ios::binary);
+			std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			importRead_++;
+			importBytes_ += text.size();
+
+			// A bare scene, named after the file, or a stored record
+			ofxSurfingSupabaseBackend::Row row;
+			std::string mismatch;
+			try {
+				ofJson json = ofJson::parse(text);
+				if (json.is_object() && json.contains("preset_name") && json.contains("preset_data")) {
+					row.name = json["preset_name"].get<std::string>();
+					json = json["preset_data"];
+				} else {
+					row.name = std::filesystem::path(path).stem().string();
+				}
+				if (isSceneShape(json, shape, mismatch)) {
+					row.payload = json.dump();
+				}
+			} catch (std::exception & e) {
+				mismatch = e.what();
+			}
 
-		try {
-			presetJson = ofJson::parse(jsonData);
-		} catch (std::exception & e) {
-			ofLogError("ofxSurfingSupabase") << "savePreset(): Invalid JSON: " << e.what();
-			isSavingRemote_ = false;
-			return;
+			std::unique_lock<std::mutex> lock(queueMutex);
+			if (row.payload.empty() || row.name.empty() || !names.insert(row.name).second) {
+				importInvalid_++;
+				if (bDebug) {
+					ofLogWarning("ofxSurfingSupabase") << "importFolder(): Skipped " << path << (mismatch.empty() ? ": duplicate or empty name" : ": " + mismatch);
+				}
+				continue;
+			}
+			queueCondition.wait(lock, [&]() { return queue.size() < queueMax; });
+			queue.push_back(std::move(row));
+			queueCondition.notify_all();
 		}
 
-		ofJson insertData;
-		insertData["user_id"] = userId_;
-		insertData["preset_name"] = presetNameCopy;
-		insertData["preset_data"] = presetJson;
+		std::lock_guard<std::mutex> lock(queueMutex);
+		readersRunning--;
+		queueCondition.notify_all();
+	};
 
-		std::string endpoint = "/rest/v1/" + TABLE_NAME + "?on_conflict=user_id,preset_name";
-		std::string body = insertData.dump();
+	std::vector<std::thread> readers;
+	for (int i = readersRunning; i > 0; --i) {
+		readers.emplace_back(reader);
+	}
 
-		if (bDebug) {
-			ofLogNotice("ofxSurfingSupabase") << "savePreset(): Saving to: " << endpoint;
-			ofLogNotice("ofxSurfingSupabase") << "savePreset(): Preset name: " << presetNameCopy;
+	while (true) {
+		std::vector<ofxSurfingSupabaseBackend::Row> batch;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [&]() { return queue.size() >= static_cast<std::size_t>(batchSize) || readersRunning == 0; });
+			while (!queue.empty() && batch.size() < static_cast<std::size_t>(batchSize)) {
+				batch.push_back(std::move(queue.front()));
+				queue.pop_front();
+			}
 		}
+		queueCondition.notify_all();
+		if (batch.empty()) break;
 
-		HttpResponse res = httpPost(endpoint, body);
+		std::vector<ofxSurfingSupabaseBackend::Row> saved;
+		auto res = backend->saveBulk(batch, true, saved);
 
 		if (res.success) {
-			ofLogNotice("ofxSurfingSupabase") << "savePreset(): ✓ Preset saved successfully";
-
-			std::string listEndpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&select=preset_name&order=created_at.asc";
-			HttpResponse listRes = httpGet(listEndpoint);
-			if (listRes.success) {
-				try {
-					ofJson responseJson = ofJson::parse(listRes.body);
-					std::vector<std::string> list;
-					if (responseJson.is_array()) {
-						for (auto & item : responseJson) {
-							if (item.contains("preset_name")) {
-								list.push_back(item["preset_name"].get<std::string>());
-							}
-						}
-					}
-					{
-						std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
-						pendingPresetList_ = std::move(list);
-						hasPendingPresetList_ = true;
-					}
-				} catch (std::exception & e) {
-					ofLogError("ofxSurfingSupabase") << "savePreset(): Failed to parse preset list: " << e.what();
-				}
-			} else {
-				ofLogError("ofxSurfingSupabase") << "savePreset(): Failed to refresh preset list: HTTP " << listRes.statusCode;
-				if (bDebug) {
-					ofLogError("ofxSurfingSupabase") << listRes.body;
-				}
+			std::unordered_map<std::string, const std::string *> payloads;
+			for (auto & row : batch) payloads[row.name] = &row.payload;
+			for (auto & row : saved) {
+				auto it = payloads.find(row.name);
+				if (it != payloads.end()) onPresetSaved(row, *it->second);
 			}
+			importUploaded_ += static_cast<int>(batch.size());
 		} else {
-			ofLogError("ofxSurfingSupabase") << "savePreset(): ✗ Failed to save preset: HTTP " << res.statusCode;
+			importFailed_ += static_cast<int>(batch.size());
+			ofLogError("ofxSurfingSupabase") << "importFolder(): ✗ Failed to upload " << batch.size() << " presets: HTTP " << res.status;
 			if (bDebug) {
-				ofLogError("ofxSurfingSupabase") << res.body;
+				ofLogError("ofxSurfingSupabase") << res.error;
 			}
 		}
 
-		isSavingRemote_ = false;
-	}).detach();
+		if (bDebug) {
+			auto progress = getImportProgress();
+			ofLogNotice("ofxSurfingSupabase") << "importFolder(): " << progress.uploaded << " / " << progress.files << " (" << ofToString(progress.getRate(), 1) << " presets/s)";
+		}
+	}
+
+	for (auto & thread : readers) {
+		thread.join();
+	}
 }
 
 //--------------------------------------------------------------
-void ofxSurfingSupabase::savePresetNew(const std::string & presetName) {
-	ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): " << presetName;
+bool ofxSurfingSupabase::isSceneShape(const ofJson & json, const ofJson & shape, std::string & mismatch) {
+	// Every group and parameter of the scene, groups as objects and parameters as values.
+	// Extra keys are ignored, as ofDeserialize does
+	if (!shape.is_object()) return true;
+	if (!json.is_object()) {
+		mismatch = "not an object";
+		return false;
+	}
+	for (auto it = shape.begin(); it != shape.end(); ++it) {
+		auto found = json.find(it.key());
+		if (found == json.end()) {
+			mismatch = "missing " + it.key();
+			return false;
+		}
+		if (it.value().is_object()) {
+			if (!isSceneShape(*found, it.value(), mismatch)) {
+				mismatch = it.key() + "/" + mismatch;
+				return false;
+			}
+		} else if (found->is_object() || found->is_array()) {
+			mismatch = it.key() + " is not a value";
+			return false;
+		}
+	}
+	return true;
+}
 
-	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "Not connected";
+//--------------------------------------------------------------
+ofxSurfingSupabase::ImportProgress ofxSurfingSupabase::getImportProgress() const {
+	ImportProgress progress;
+	progress.running = isImporting_;
+	progress.files = importFiles_;
+	progress.read = importRead_;
+	progress.invalid = importInvalid_;
+	progress.uploaded = importUploaded_;
+	progress.failed = importFailed_;
+	progress.bytes = importBytes_;
+	uint64_t timeStart = importTimeStart_;
+	uint64_t timeEnd = importTimeEnd_;
+	if (timeStart > 0) progress.elapsedMs = (timeEnd > 0 ? timeEnd : ofGetElapsedTimeMillis()) - timeStart;
+	return progress;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::exportPresets(const std::string & folder, const std::string & bundlePath) {
+	ofLogNotice("ofxSurfingSupabase") << "exportPresets(): " << folder;
+
+	if (!bConnected || !getBackend()) {
+		ofLogWarning("ofxSurfingSupabase") << "exportPresets(): Not connected";
 		return;
 	}
-
-	if (isSavingRemote_.exchange(true)) {
-		ofLogWarning("ofxSurfingSupabase") << "savePresetNew(): Save already in progress";
+	if (isExporting_.exchange(true)) {
+		ofLogWarning("ofxSurfingSupabase") << "exportPresets(): Export already in progress";
 		return;
 	}
 
-	std::string baseName = presetName.empty() ? generateTimestampName() : presetName;
-	std::string jsonData = serializeSceneToJson();
+	std::string folderPath = ofToDataPath(folder, true);
+	std::string bundleFile = bundlePath.empty() ? "" : ofToDataPath(bundlePath, true);
+	std::error_code ec;
+	std::filesystem::create_directories(folderPath, ec);
+	if (ec) {
+		ofLogError("ofxSurfingSupabase") << "exportPresets(): ✗ Can't create " << folderPath << ": " << ec.message();
+		isExporting_ = false;
+		return;
+	}
 
-	std::thread([this, baseName, jsonData]() {
-		ofJson presetJson;
+	exportTotal_ = -1;
+	exportFetched_ = 0;
+	exportWritten_ = 0;
+	exportFailed_ = 0;
+	exportBytes_ = 0;
+	exportFetchMs_ = 0;
+	exportQueuedPeak_ = 0;
+	exportTimeStart_ = ofGetElapsedTimeMillis();
+	exportTimeEnd_ = 0;
+
+	std::thread([this, folderPath, bundleFile]() {
+		// Paged like a list refresh: behind loads and saves, waiting for rate limit tokens rather than failing
+		ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_LIST);
+		exportPresetsThread(folderPath, bundleFile);
+		exportTimeEnd_ = ofGetElapsedTimeMillis();
+		isExporting_ = false;
+
+		auto progress = getExportProgress();
+		ofLogNotice("ofxSurfingSupabase") << "exportPresets(): " << (progress.failed == 0 ? "✓ " : "✗ ") << progress.written << " of " << progress.fetched << " written, "
+										  << progress.failed << " failed, " << ofToString(progress.elapsedMs / 1000.0, 1) << " s ("
+										  << ofToString(progress.getRate(), 1) << " presets/s, " << ofToString(progress.getMegabytesPerSecond(), 2) << " MB/s, "
+										  << progress.fetchMs << " ms waiting on the backend, at most " << progress.queuedPeak << " rows queued)";
+	}).detach();
+}
 
-		try {
-			presetJson = ofJson::parse(jsonData);
-		} catch (std::exception & e) {
-			ofLogError("ofxSurfingSupabase") << "savePresetNew(): Invalid JSON: " << e.what();
-			isSavingRemote_ = false;
+//--------------------------------------------------------------
+void ofxSurfingSupabase::exportPresetsThread(const std::string & folder, const std::string & bundlePath) {
+	auto backend = getBackend();
+	if (!backend) return;
+
+	std::ofstream bundle;
+	if (!bundlePath.empty()) {
+		bundle.open(bundlePath, std::ios::binary | std::ios::trunc);
+		if (!bundle) {
+			ofLogError("ofxSurfingSupabase") << "exportPresets(): ✗ Can't create " << bundlePath;
 			return;
 		}
+	}
 
-		std::string endpoint = "/rest/v1/" + TABLE_NAME;
-
-		for (int attempt = 0; attempt < 100; ++attempt) {
-			std::string name = (attempt == 0) ? baseName : baseName + "_" + ofToString(attempt);
+	// This thread streams the pages of the table while the writers empty a bounded queue:
+	// memory holds the row being parsed and at most EXPORT_QUEUE_PAGES pages of rows queued,
+	// a full queue holds the response back
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::deque<ofxSurfingSupabaseBackend::Row> queue;
+	std::size_t queueMax = static_cast<std::size_t>(EXPORT_PAGE_SIZE) * EXPORT_QUEUE_PAGES;
+	bool fetching = true;
+
+	auto writer = [&]() {
+		while (true) {
+			ofxSurfingSupabaseBackend::Row row;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				queueCondition.wait(lock, [&]() { return !queue.empty() || !fetching; });
+				if (queue.empty()) return;
+				row = std::move(queue.front());
+				queue.pop_front();
+			}
+			queueCondition.notify_all();
 
-			ofJson insertData;
-			insertData["user_id"] = userId_;
-			insertData["preset_name"] = name;
-			insertData["preset_data"] = presetJson;
+			// Written aside and renamed, a backup never holds half a preset
+			std::string path = ofFilePath::join(folder, ofxSurfingSupabaseBackendLocal::encodeFileName(row.name) + ".json");
+			std::string pathTemp = path + ".tmp";
+			bool ok = false;
+			try {
+				ofJson json;
+				json["preset_name"] = row.name;
+				json["updated_at"] = row.updatedAt;
+				json["preset_data"] = ofJson::parse(row.payload);
+				std::string text = json.dump();
+
+				std::ofstream file(pathTemp, std::ios::binary | std::ios::trunc);
+				file.write(text.data(), text.size());
+				file.close();
+				std::error_code ec;
+				if (file) std::filesystem::rename(pathTemp, path, ec);
+				ok = file && !ec;
+				if (ok) exportBytes_ += text.size();
+			} catch (std::exception & e) {
+				ofLogError("ofxSurfingSupabase") << "exportPresets(): Invalid JSON for " << row.name << ": " << e.what();
+			}
 
-			HttpResponse res = httpPost(endpoint, insertData.dump());
+			if (ok) {
+				exportWritten_++;
+			} else {
+				exportFailed_++;
+				ofLogError("ofxSurfingSupabase") << "exportPresets(): ✗ Can't write " << path;
+			}
+		}
+	};
 
-			if (res.success) {
-				ofLogNotice("ofxSurfingSupabase") << "savePresetNew(): ✓ Preset saved as: " << name;
-
-				std::string listEndpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&select=preset_name&order=created_at.asc";
-				HttpResponse listRes = httpGet(listEndpoint);
-				if (listRes.success) {
-					try {
-						ofJson responseJson = ofJson::parse(listRes.body);
-						std::vector<std::string> list;
-						if (responseJson.is_array()) {
-							for (auto & item : responseJson) {
-								if (item.contains("preset_name")) {
-									list.push_back(item["preset_name"].get<std::string>());
-								}
-							}
-						}
-						{
-							std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
-							pendingPresetList_ = std::move(list);
-							hasPendingPresetList_ = true;
-						}
-					} catch (std::exception & e) {
-						ofLogError("ofxSurfingSupabase") << "savePresetNew(): Failed to parse preset list: " << e.what();
-					}
-				} else {
-					ofLogError("ofxSurfingSupabase") << "savePresetNew(): Failed to refresh preset list: HTTP " << listRes.statusCode;
-					if (bDebug) {
-						ofLogError("ofxSurfingSupabase") << listRes.body;
-					}
-				}
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	std::vector<std::thread> writers;
+	for (int i = ofClamp(cores, 1, static_cast<int>(EXPORT_WRITERS_MAX)); i > 0; --i) {
+		writers.emplace_back(writer);
+	}
 
-				isSavingRemote_ = false;
-				return;
+	ofxSurfingSupabaseBackend::Query query;
+	query.withData = true;
+	query.count = true;
+	query.limit = EXPORT_PAGE_SIZE;
+
+	while (true) {
+		int rowsPaged = 0;
+		int total = -1;
+		uint64_t fetchStart = ofGetElapsedTimeMillis();
+		uint64_t queueWaitMs = 0;
+		auto res = backend->listEach(query, [&](ofxSurfingSupabaseBackend::Row & row) {
+			rowsPaged++;
+			exportFetched_++;
+
+			if (bundle) {
+				bundle << "{\"preset_name\":" << ofJson(row.name).dump() << ",\"updated_at\":" << ofJson(row.updatedAt).dump()
+					   << ",\"preset_data\":" << (row.payload.empty() ? "null" : row.payload) << "}\n";
 			}
 
-			if (res.statusCode != 409) {
-				ofLogError("ofxSurfingSupabase") << "savePresetNew(): ✗ Failed to save preset: HTTP " << res.statusCode;
-				if (bDebug) {
-					ofLogError("ofxSurfingSupabase") << res.body;
-				}
-				isSavingRemote_ = false;
-				return;
+			uint64_t waitStart = ofGetElapsedTimeMillis();
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [&]() { return queue.size() < queueMax; });
+			queue.push_back(std::move(row));
+			exportQueuedPeak_ = std::max(exportQueuedPeak_.load(), static_cast<int>(queue.size()));
+			lock.unlock();
+			queueCondition.notify_all();
+			queueWaitMs += ofGetElapsedTimeMillis() - waitStart;
+		}, total);
+		exportFetchMs_ += ofGetElapsedTimeMillis() - fetchStart - queueWaitMs;
+
+		if (!res.success) {
+			ofLogError("ofxSurfingSupabase") << "exportPresets(): ✗ Failed to list from " << query.offset << ": HTTP " << res.status;
+			if (bDebug) {
+				ofLogError("ofxSurfingSupabase") << res.error;
 			}
+			exportFailed_++;
+			break;
+		}
+		if (query.count) {
+			exportTotal_ = total;
+			query.count = false;
 		}
 
-		ofLogError("ofxSurfingSupabase") << "savePresetNew(): ✗ Failed to find unique name";
-		isSavingRemote_ = false;
-	}).detach();
+		if (bDebug) {
+			ofLogNotice("ofxSurfingSupabase") << "exportPresets(): " << exportFetched_.load() << " / " << exportTotal_.load();
+		}
+
+		// PostgREST answers 416 past the last row: a library of whole pages ends on the count
+		if (rowsPaged < EXPORT_PAGE_SIZE) break;
+		query.offset += EXPORT_PAGE_SIZE;
+		if (exportTotal_ >= 0 && query.offset >= exportTotal_) break;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		fetching = false;
+	}
+	queueCondition.notify_all();
+	for (auto & thread : writers) {
+		thread.join();
+	}
+
+	if (bundle) {
+		bundle.close();
+		if (!bundle) {
+			ofLogError("ofxSurfingSupabase") << "exportPresets(): ✗ Can't write " << bundlePath;
+			exportFailed_++;
+		}
+	}
 }
 
 //--------------------------------------------------------------
-void ofxSurfingSupabase::loadPreset(const std::string & presetName) {
-	ofLogNotice("ofxSurfingSupabase") << "loadPreset(): " << presetName;
+ofxSurfingSupabase::ExportProgress ofxSurfingSupabase::getExportProgress() const {
+	ExportProgress progress;
+	progress.running = isExporting_;
+	progress.total = exportTotal_;
+	progress.fetched = exportFetched_;
+	progress.written = exportWritten_;
+	progress.failed = exportFailed_;
+	progress.bytes = exportBytes_;
+	progress.fetchMs = exportFetchMs_;
+	progress.queuedPeak = exportQueuedPeak_;
+	uint64_t timeStart = exportTimeStart_;
+	uint64_t timeEnd = exportTimeEnd_;
+	if (timeStart > 0) progress.elapsedMs = (timeEnd > 0 ? timeEnd : ofGetElapsedTimeMillis()) - timeStart;
+	return progress;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::deletePresetRemote(const std::string & presetName) {
+	deletePresetsRemote({ presetName });
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::deletePresetsRemote(const std::vector<std::string> & presetNames) {
+	ofLogNotice("ofxSurfingSupabase") << "deletePresetsRemote(): " << presetNames.size() << " presets";
+
+	std::string userId = getJournalUserId();
+	if (userId.empty()) {
+		ofLogWarning("ofxSurfingSupabase") << "deletePresetsRemote(): Not connected";
+		return;
+	}
+	if (presetNames.empty()) return;
+
+	// Remote mode: one request at once, the list is patched now and confirmed by a refresh
+	if (bRemoteMode && journal_.size() == 0) {
+		ofxSurfingSupabaseJournal::Entry entry;
+		entry.op = ofxSurfingSupabaseJournal::OP_DELETE;
+		entry.userId = userId;
+		if (!writeRemote(entry, presetNames)) return;
+		for (auto & name : presetNames) {
+			cache_.erase(name);
+		}
+		patchPresetNamesRemoved(presetNames);
+		return;
+	}
+
+	// Queued behind any pending save of the same presets,
+	// the journal worker sends the run in one request
+	for (auto & name : presetNames) {
+		journal_.append(ofxSurfingSupabaseJournal::OP_DELETE, userId, name, "");
+		cache_.erase(name);
+	}
+	journalCondition_.notify_one();
+
+	patchPresetNamesRemoved(presetNames);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::refreshPresetListRemote() {
+	ofLogNotice("ofxSurfingSupabase") << "refreshPresetListRemote()";
 
 	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Not connected";
+		ofLogWarning("ofxSurfingSupabase") << "refreshPresetListRemote(): Not connected";
 		return;
 	}
 
-	if (isLoadingRemote_.exchange(true)) {
-		ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Load already in progress";
+	// One refresh at a time, a request meanwhile runs right after it
+	if (isRefreshingRemote_.exchange(true)) {
+		bRefreshQueued_ = true;
 		return;
 	}
 
-	std::string endpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&preset_name=eq." + presetName + "&select=preset_data";
-	std::string presetNameCopy = presetName;
+	// Snapshot what the worker needs to decide between nothing, a merge or a reset
+	PresetListSync sync;
+	sync.generation = presetListGeneration_;
+	bool synced = listSynced_;
+	bool complete = isPresetListComplete();
+	int localCount = static_cast<int>(presetsNamesRemote.size()) - countPresetNamesUnpushed();
+	std::string watermark = listWatermark_;
+	int page = std::max(0, selectedPresetIndexRemote.get()) / LIST_PAGE_SIZE;
+
+	std::thread([this, sync, synced, complete, localCount, watermark, page]() mutable {
+		ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_LIST);
+		syncPresetListRemote(sync, synced, complete, localCount, watermark, page);
+
+		std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+		pendingPresetListSync_ = std::move(sync);
+		hasPendingPresetListSync_ = true;
+	}).detach();
+}
 
-	std::thread([this, endpoint, presetNameCopy]() {
-		HttpResponse res = httpGet(endpoint);
+//--------------------------------------------------------------
+void ofxSurfingSupabase::syncPresetListRemote(PresetListSync & sync, bool synced, bool complete, int localCount, const std::string & watermark, int page) {
+	// Worker thread: network only, the result is applied in update()
 
-		if (res.success) {
-			try {
-				ofJson responseJson = ofJson::parse(res.body);
-
-				if (responseJson.is_array() && !responseJson.empty() && responseJson[0].contains("preset_data")) {
-					std::string presetData = responseJson[0]["preset_data"].dump();
-					{
-						std::lock_guard<std::mutex> lock(pendingPresetMutex_);
-						pendingPresetJson_ = presetData;
-						pendingPresetName_ = presetNameCopy;
-						hasPendingPreset_ = true;
-					}
-				} else {
-					ofLogWarning("ofxSurfingSupabase") << "loadPreset(): Preset not found";
-				}
-			} catch (std::exception & e) {
-				ofLogError("ofxSurfingSupabase") << "loadPreset(): Failed to parse response: " << e.what();
-			}
-		} else {
-			ofLogError("ofxSurfingSupabase") << "loadPreset(): ✗ Failed to load preset: HTTP " << res.statusCode;
+	// One tiny request tells whether anything changed since the last sync
+	if (!probePresetListRemote(sync.remoteCount, sync.remoteNewest)) {
+		sync.type = PresetListSync::FAILED;
+		return;
+	}
+
+	if (synced && sync.remoteCount == localCount && sync.remoteNewest == watermark) {
+		sync.type = PresetListSync::UNCHANGED;
+		return;
+	}
+
+	// Merging needs every name locally; a partially paged list just reloads its pages
+	if (synced && complete) {
+		auto backend = getBackend();
+		if (!backend) {
+			sync.type = PresetListSync::FAILED;
+			return;
+		}
+
+		// Rows inserted or updated since the last sync, with payloads to tell our own echoes apart
+		ofxSurfingSupabaseBackend::Query query;
+		query.updatedAfter = watermark;
+		query.withData = true;
+		std::vector<ofxSurfingSupabaseBackend::Row> rows;
+		int total;
+		auto res = backend->list(query, rows, total);
+
+		if (!res.success) {
+			ofLogError("ofxSurfingSupabase") << "refreshPresetListRemote(): ✗ Failed to fetch changes: HTTP " << res.status;
 			if (bDebug) {
-				ofLogError("ofxSurfingSupabase") << res.body;
+				ofLogError("ofxSurfingSupabase") << res.error;
 			}
+			sync.type = PresetListSync::FAILED; // Keep the current list, nothing learned
+			return;
 		}
 
-		isLoadingRemote_ = false;
-	}).detach();
+		sync.watermark = watermark;
+		for (auto & row : rows) {
+			sync.names.push_back(row.name);
+			if (isNewerTimestamp(row.updatedAt, sync.watermark)) sync.watermark = row.updatedAt;
+
+			// Our own saves come back here too, with the payload the cache holds.
+			// A pending local save wins, other cached copies take the row.
+			ofxSurfingSupabaseCache::Info info;
+			if (!cache_.getInfo(row.name, info)) {
+				sync.changed.push_back(row.name);
+			} else if (!info.updatedAt.empty() && row.updatedAt != info.updatedAt) {
+				if (info.hash != ofxSurfingSupabaseCache::hashPayload(row.payload)) sync.changed.push_back(row.name);
+				cache_.put(row.name, row.payload, row.updatedAt);
+			}
+		}
+		sync.type = PresetListSync::MERGE;
+		return;
+	}
+
+	// Full refresh: size the list and fetch only the page under the selection
+	sync.type = PresetListSync::RESET;
+	int pages = (sync.remoteCount + LIST_PAGE_SIZE - 1) / LIST_PAGE_SIZE;
+	if (pages == 0) return;
+
+	sync.page = std::min(page, pages - 1);
+	if (!fetchPresetListPage(sync.page, sync.names, sync.pageTotal)) {
+		sync.page = -1; // Loaded on demand later
+	}
 }
 
 //--------------------------------------------------------------
-void ofxSurfingSupabase::deletePresetRemote(const std::string & presetName) {
-	ofLogNotice("ofxSurfingSupabase") << "deletePresetRemote(): " << presetName;
+void ofxSurfingSupabase::applyPresetListSync(const PresetListSync & sync) {
+	if (sync.type == PresetListSync::FAILED) return;
 
-	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "deletePresetRemote(): Not connected";
+	if (sync.type == PresetListSync::UNCHANGED) {
+		if (bDebug) {
+			ofLogNotice("ofxSurfingSupabase") << "refreshPresetListRemote(): Unchanged (" << sync.remoteCount << " presets)";
+		}
 		return;
 	}
 
-	std::string endpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&preset_name=eq." + presetName;
+	if (sync.type == PresetListSync::MERGE) {
+		// Merge in place: updated rows keep their slot, new rows are appended
+		std::size_t added = 0;
+		for (auto & name : sync.names) {
+			if (findPresetIndex(name) < 0) {
+				presetsNamesRemote.push_back(name);
+				presetIndexByName_[name] = static_cast<int>(presetsNamesRemote.size()) - 1;
+				++added;
+			}
+		}
+		listWatermark_ = sync.watermark;
+		resizePresetListPages();
+		if (added > 0) ++presetListRevision_;
+
+		// Deletions leave no rows behind, so compare against the probed row count.
+		// This also catches rows committed with an older updated_at than the watermark.
+		if (sync.remoteCount != static_cast<int>(presetsNamesRemote.size()) - static_cast<int>(presetNamesUnpushed_.size())) {
+			ofLogNotice("ofxSurfingSupabase") << "refreshPresetListRemote(): Local list diverged, full refresh";
+			listSynced_ = false;
+			bRefreshQueued_ = true;
+			return;
+		}
 
-	HttpResponse res = httpDelete(endpoint);
+		if (bDebug) {
+			ofLogNotice("ofxSurfingSupabase") << "refreshPresetListRemote(): " << sync.names.size() << " changed, " << added << " added";
+		}
+		ofLogNotice("ofxSurfingSupabase") << "✓ Found " << presetsNamesRemote.size() << " presets";
 
-	if (res.success) {
-		ofLogNotice("ofxSurfingSupabase") << "deletePresetRemote(): ✓ Preset deleted successfully";
-		refreshPresetListRemote();
+		if (added > 0) {
+			updateSelectedIndexRange();
+		}
 
-		// Adjust selected index if needed
-		if (selectedPresetIndexRemote >= presetsNamesRemote.size() && !presetsNamesRemote.empty()) {
-			selectedPresetIndexRemote = presetsNamesRemote.size() - 1;
+		// Reload the selected preset only when its own row changed
+		if (bAutoLoad && !selectedPresetName_.empty()
+			&& std::find(sync.changed.begin(), sync.changed.end(), selectedPresetName_) != sync.changed.end()) {
+			loadAndApplyRemote();
 		}
-		//clamp selected index
-		selectedPresetIndexRemote.setMin(0);
-		selectedPresetIndexRemote.setMax(presetsNamesRemote.size() - 1);
-	} else {
-		ofLogError("ofxSurfingSupabase") << "deletePresetRemote(): ✗ Failed to delete preset: HTTP " << res.statusCode;
+		return;
+	}
+
+	// RESET: every page starts unloaded until fetched
+	++presetListGeneration_;
+	++presetListRevision_;
+	presetsNamesRemote.assign(sync.remoteCount, std::string());
+	presetIndexByName_.clear();
+	presetListPagesLoaded_.assign((sync.remoteCount + LIST_PAGE_SIZE - 1) / LIST_PAGE_SIZE, false);
+	presetListPagesInFlight_.clear();
+	listWatermark_ = sync.remoteNewest;
+	listSynced_ = true;
+
+	ofLogNotice("ofxSurfingSupabase") << "✓ Found " << presetsNamesRemote.size() << " presets";
+
+	// Saves not pushed yet are not in the remote rows: keep them listed
+	mergePresetNamesUnpushed();
+
+	if (sync.page >= 0) {
+		applyPresetListPage(sync.page, sync.names, sync.pageTotal);
+	}
+
+	updateSelectedIndexRange();
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabase::probePresetListRemote(int & remoteCount, std::string & remoteNewest) {
+	auto backend = getBackend();
+	if (!backend) return false;
+
+	auto res = backend->probe(remoteCount, remoteNewest);
+
+	if (!res.success) {
+		ofLogError("ofxSurfingSupabase") << "refreshPresetListRemote(): ✗ Change probe failed: HTTP " << res.status;
 		if (bDebug) {
-			ofLogError("ofxSurfingSupabase") << res.body;
+			ofLogError("ofxSurfingSupabase") << res.error;
 		}
+		return false;
 	}
+
+	return true;
 }
 
 //--------------------------------------------------------------
-void ofxSurfingSupabase::refreshPresetListRemote() {
-	ofLogNotice("ofxSurfingSupabase") << "refreshPresetListRemote()";
+bool ofxSurfingSupabase::fetchPresetListPage(int page, std::vector<std::string> & names, int & total) {
+	// Safe to call from worker threads
+	auto backend = getBackend();
+	if (!backend) return false;
 
-	if (!bConnected) {
-		ofLogWarning("ofxSurfingSupabase") << "refreshPresetListRemote(): Not connected";
-		return;
+	ofxSurfingSupabaseBackend::Query query;
+	query.offset = page * LIST_PAGE_SIZE;
+	query.limit = LIST_PAGE_SIZE;
+	query.count = true;
+
+	std::vector<ofxSurfingSupabaseBackend::Row> rows;
+	auto res = backend->list(query, rows, total);
+
+	if (!res.success) {
+		ofLogError("ofxSurfingSupabase") << "fetchPresetListPage(): ✗ Failed to load page " << page << ": HTTP " << res.status;
+		if (bDebug) {
+			ofLogError("ofxSurfingSupabase") << res.error;
+		}
+		return false;
 	}
 
-	//// Sort descendent
-	//std::string endpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&select=preset_name&order=created_at.desc";
-	// Sort ascendent
-	std::string endpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_ + "&select=preset_name&order=created_at.asc";
+	for (auto & row : rows) {
+		names.push_back(row.name);
+	}
+	return true;
+}
 
-	HttpResponse res = httpGet(endpoint);
+//--------------------------------------------------------------
+void ofxSurfingSupabase::applyPresetListPage(int page, const std::vector<std::string> & names, int total) {
+	presetListPagesInFlight_.erase(page);
 
-	if (res.success) {
-		try {
-			ofJson responseJson = ofJson::parse(res.body);
+	if (page < 0 || page >= static_cast<int>(presetListPagesLoaded_.size())) return;
 
-			presetsNamesRemote.clear();
+	// Rows moved under us: the page offsets no longer match our slots
+	if (total >= 0 && total != static_cast<int>(presetsNamesRemote.size()) - static_cast<int>(presetNamesUnpushed_.size())) {
+		ofLogNotice("ofxSurfingSupabase") << "applyPresetListPage(): Row count changed, list will resync";
+		listSynced_ = false;
+	}
 
-			if (responseJson.is_array()) {
-				for (auto & item : responseJson) {
-					if (item.contains("preset_name")) {
-						presetsNamesRemote.push_back(item["preset_name"].get<std::string>());
-					}
-				}
-			}
+	std::size_t first = static_cast<std::size_t>(page) * LIST_PAGE_SIZE;
+	for (std::size_t i = 0; i < names.size() && first + i < presetsNamesRemote.size(); ++i) {
+		setPresetName(first + i, names[i]);
+	}
+	presetListPagesLoaded_[page] = true;
+	++presetListRevision_;
 
-			ofLogNotice("ofxSurfingSupabase") << "✓ Found " << presetsNamesRemote.size() << " presets";
+	// The selected preset may turn up on this page
+	updateSelectedIndexRange();
 
-			// Clamp selected index
-			selectedPresetIndexRemote.setMin(0);
-			selectedPresetIndexRemote.setMax(presetsNamesRemote.size() - 1);
+	if (bDebug) {
+		ofLogNotice("ofxSurfingSupabase") << "applyPresetListPage(): Page " << page << " (" << names.size() << " names)";
+	}
+}
 
-			if (!presetsNamesRemote.empty() && selectedPresetIndexRemote < 0) {
-				selectedPresetIndexRemote = 0;
-			}
+//--------------------------------------------------------------
+void ofxSurfingSupabase::requestPresetListPages(int indexFirst, int indexLast) {
+	if (presetListPagesLoaded_.empty()) return;
 
-			// Clamp index
-			if (selectedPresetIndexRemote >= presetsNamesRemote.size()) {
-				selectedPresetIndexRemote = presetsNamesRemote.empty() ? -1 : presetsNamesRemote.size() - 1;
-			}
+	int pageFirst = std::max(0, indexFirst / LIST_PAGE_SIZE);
+	int pageLast = std::min(static_cast<int>(presetListPagesLoaded_.size()) - 1, std::max(0, indexLast) / LIST_PAGE_SIZE);
 
-		} catch (std::exception & e) {
-			ofLogError("ofxSurfingSupabase") << "refreshPresetListRemote(): Failed to parse preset list: " << e.what();
-		}
-	} else {
-		ofLogError("ofxSurfingSupabase") << "refreshPresetListRemote(): ✗ Failed to refresh preset list: HTTP " << res.statusCode;
-		if (bDebug) {
-			ofLogError("ofxSurfingSupabase") << res.body;
-		}
+	for (int page = pageFirst; page <= pageLast; ++page) {
+		if (presetListPagesLoaded_[page] || presetListPagesInFlight_.count(page)) continue;
+
+		presetListPagesInFlight_.insert(page);
+		int generation = presetListGeneration_;
+
+		std::thread([this, page, generation]() {
+			ofxSurfingSupabaseBackend::ScopedPriority priority(ofxSurfingSupabaseBackend::PRIORITY_LIST);
+			std::vector<std::string> names;
+			int total = -1;
+			bool ok = fetchPresetListPage(page, names, total);
+
+			std::lock_guard<std::mutex> lock(pendingPresetListMutex_);
+			pendingPresetPages_.push_back({ page, generation, ok, total, std::move(names) });
+			hasPendingPresetPages_ = true;
+		}).detach();
 	}
 }
 
+//--------------------------------------------------------------
+bool ofxSurfingSupabase::isPresetListComplete() const {
+	return std::all_of(presetListPagesLoaded_.begin(), presetListPagesLoaded_.end(), [](bool loaded) { return loaded; });
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::resizePresetListPages() {
+	// Slots appended locally are known, so any page they open is complete
+	std::size_t pages = (presetsNamesRemote.size() + LIST_PAGE_SIZE - 1) / LIST_PAGE_SIZE;
+	presetListPagesLoaded_.resize(pages, true);
+}
+
 //--------------------------------------------------------------
 void ofxSurfingSupabase::clearDatabase() {
 	ofLogNotice("ofxSurfingSupabase") << "clearDatabase()";
 
-	if (!bConnected) {
+	std::string userId = getJournalUserId();
+	if (userId.empty()) {
 		ofLogWarning("ofxSurfingSupabase") << "clearDatabase(): Not connected";
 		return;
 	}
 
-	ofLogWarning("ofxSurfingSupabase") << "⚠️  Deleting ALL presets for user: " << userId_;
+	ofLogWarning("ofxSurfingSupabase") << "⚠️  Deleting ALL presets for user: " << userId;
 
-	std::string endpoint = "/rest/v1/" + TABLE_NAME + "?user_id=eq." + userId_;
+	// Remote mode: sent at once, update() clears the local state when it is confirmed
+	if (bRemoteMode && journal_.size() == 0) {
+		ofxSurfingSupabaseJournal::Entry entry;
+		entry.op = ofxSurfingSupabaseJournal::OP_CLEAR;
+		entry.userId = userId;
+		writeRemote(entry);
+		return;
+	}
 
-	HttpResponse res = httpDelete(endpoint);
+	// Queued behind the pending saves and deletes, which stay until the wipe is confirmed.
+	// The journal worker sends it and retries while offline, update() clears the local state.
+	journal_.append(ofxSurfingSupabaseJournal::OP_CLEAR, userId, "", "");
+	journalCondition_.notify_one();
+}
 
-	if (res.success) {
-		ofLogNotice("ofxSurfingSupabase") << "clearDatabase(): ✓ Database cleared successfully";
-		presetsNamesRemote.clear();
-		selectedPresetIndexRemote = -1;
-		selectedPresetIndexRemote.setMin(-1);
-		selectedPresetIndexRemote.setMax(-1);
-	} else {
-		ofLogError("ofxSurfingSupabase") << "clearDatabase(): ✗ Failed to clear database: HTTP " << res.statusCode;
-		if (bDebug) {
-			ofLogError("ofxSurfingSupabase") << res.body;
-		}
+//--------------------------------------------------------------
+void ofxSurfingSupabase::applyDatabaseCleared() {
+	ofLogNotice("ofxSurfingSupabase") << "clearDatabase(): ✓ Database cleared successfully";
+
+	presetsNamesRemote.clear();
+	presetIndexByName_.clear();
+	selectedPresetName_.clear();
+	listWatermark_.clear();
+	replicaWatermark_.clear();
+	listSynced_ = true; // Known empty
+	++presetListGeneration_;
+	++presetListRevision_;
+	presetListPagesLoaded_.clear();
+	presetListPagesInFlight_.clear();
+	selectedPresetIndexRemote = -1;
+	selectedPresetIndexRemote.setMin(-1);
+	selectedPresetIndexRemote.setMax(-1);
+
+	// Saves queued after the wipe are still on their way
+	presetNamesUnpushed_.clear();
+	for (auto & name : journal_.getPendingNames()) {
+		presetNamesUnpushed_.insert(name);
+		patchPresetNameAdded(name);
 	}
 }
 
@@ -1005,13 +2655,59 @@ void ofxSurfingSupabase::selectedIndexRemoteUpdate() {
 		selectedPresetIndexRemote = selectedPresetIndexRemote.get() % presetsNamesRemote.size(); //cycled
 	}
 
+	scrollPresetListTo(selectedPresetIndexRemote.get());
+	selectedPresetName_ = getSelectedIndexName();
+
 	// auto load current preset index
+	bAutoLoadDeferred_ = false;
 	if (bAutoLoad) {
 		loadAndApplyRemote();
 	}
 	ofLogNotice("ofxSurfingSupabase") << "selectedIndexRemoteUpdate(): Preset index: " << selectedPresetIndexRemote.get() << " name:  " << presetsNamesRemote[selectedPresetIndexRemote.get()];
 }
 
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::getSelectedPresetName() const {
+	// Empty when nothing is selected or its page is not loaded yet.
+	// Also while the selected preset waits for its page after a full refresh:
+	// the index was kept, but the name under it belongs to another preset.
+	std::string name = getSelectedIndexName();
+	if (!selectedPresetName_.empty() && name != selectedPresetName_) return "";
+	return name;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabase::getSelectedIndexName() const {
+	int i = selectedPresetIndexRemote.get();
+	if (i < 0 || i >= static_cast<int>(presetsNamesRemote.size())) return "";
+	return presetsNamesRemote[i];
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::scrollPresetListTo(int index) {
+	// Keep index inside the visible window
+	if (index < listScrollOffset_) {
+		listScrollOffset_ = index;
+	} else if (index >= listScrollOffset_ + LIST_ROWS_VISIBLE) {
+		listScrollOffset_ = index - LIST_ROWS_VISIBLE + 1;
+	}
+	clampPresetListScroll();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::clampPresetListScroll() {
+	int maxOffset = std::max(0, static_cast<int>(presetsNamesRemote.size()) - LIST_ROWS_VISIBLE);
+	listScrollOffset_ = ofClamp(listScrollOffset_, 0, maxOffset);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabase::mouseScrolled(int, int, float, float scrollY) {
+	if (!bDebug || presetsNamesRemote.empty()) return;
+
+	listScrollOffset_ -= static_cast<int>(scrollY) * 3;
+	clampPresetListScroll();
+}
+
 //--------------------------------------------------------------
 void ofxSurfingSupabase::selectNextRemote() {
 	if (presetsNamesRemote.empty()) return;
@@ -1039,15 +2735,3 @@ std::string ofxSurfingSupabase::getConnectionStatus() const {
 	return "DISCONNECTED";
 }
 
-//--------------------------------------------------------------
-bool ofxSurfingSupabase::SupabaseConfig::isValid() const {
-	if (authMode == "ANON_KEY") {
-		return !supabaseUrl.empty() && !supabaseAnonKey.empty();
-	}
-
-	if (authMode == "EMAIL_PASSWORD") {
-		return !supabaseUrl.empty() && !supabaseAnonKey.empty() && !email.empty() && !password.empty();
-	}
-
-	return false;
-}
@@ -2,9 +2,15 @@
 
 #include "ofMain.h"
 #include "ofxGui.h"
+#include "ofxSurfingSupabaseBackend.h"
+#include "ofxSurfingSupabaseCache.h"
+#include "ofxSurfingSupabaseJournal.h"
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <set>
 #include <thread>
+#include <unordered_set>
 
 class ofxSurfingSupabase {
 	// Lifecycle
@@ -13,6 +19,8 @@ private:
 	void setupPresetParameters(ofParameterGroup & sceneParams);
 
 public:
+	~ofxSurfingSupabase();
+
 	void setup(); // Only for using with a external presets manager
 	void setup(ofParameterGroup & sceneParams); // Main setup passing target param group
 
@@ -20,6 +28,7 @@ public:
 	void draw();
 	void exit();
 	void keyPressed(int key);
+	void mouseScrolled(int x, int y, float scrollX, float scrollY); // Scrolls the debug preset list
 
 	//--
 
@@ -27,7 +36,12 @@ public:
 	void savePreset(const std::string & presetName);
 	void savePresetNew(const std::string & presetName);
 	void loadPreset(const std::string & presetName);
+	// Fetches several presets into the cache in the background, one request per chunk of names,
+	// so later loadPreset() calls are served at once (playlists, A/B slots, prefetch)
+	void loadPresets(const std::vector<std::string> & presetNames, ofxSurfingSupabaseBackend::Priority priority = ofxSurfingSupabaseBackend::PRIORITY_PREFETCH);
 	void deletePresetRemote(const std::string & presetName);
+	// Removed from the list at once, deleted in the background: consecutive deletes share one request
+	void deletePresetsRemote(const std::vector<std::string> & presetNames);
 	void refreshPresetListRemote();
 	void clearDatabase();
 
@@ -35,10 +49,51 @@ public:
 	void selectNextRemote();
 	void selectPreviousRemote();
 	void selectedIndexRemoteUpdate();
+	std::string getSelectedPresetName() const;
 
 	// Direct scene operations (no local files)
 	void loadAndApplyRemote();
 
+	// Bulk import of a folder of preset files (*.json, named after the preset, or
+	// { preset_name, preset_data } records), validated against the scene parameters
+	// and upserted in batches in the background
+	void importFolder(const std::string & folder, int batchSize = IMPORT_BATCH_DEFAULT);
+	struct ImportProgress {
+		bool running = false;
+		int files = 0;
+		int read = 0;
+		int invalid = 0; // Unreadable, not JSON, not the scene shape or a duplicate name
+		int uploaded = 0;
+		int failed = 0;
+		uint64_t bytes = 0; // Of the files read
+		uint64_t elapsedMs = 0;
+		double getRate() const { return elapsedMs == 0 ? 0 : uploaded * 1000.0 / elapsedMs; } // Presets per second
+	};
+	ImportProgress getImportProgress() const;
+
+	// Backup of every preset to a folder, one file per preset in the local backend format
+	// (so it can be served with BACKEND=LOCAL or imported back), streamed page by page from
+	// the backend, each row parsed as it arrives, and written by a pool of workers in the background. With a bundle path, also one
+	// JSON Lines file of all the records
+	void exportPresets(const std::string & folder, const std::string & bundlePath = "");
+	struct ExportProgress {
+		bool running = false;
+		int total = -1; // Counted by the first page
+		int fetched = 0;
+		int written = 0;
+		int failed = 0;
+		uint64_t bytes = 0; // Written to the preset files
+		uint64_t fetchMs = 0; // Spent waiting on the backend
+		int queuedPeak = 0; // Most rows held ahead of the writers, the memory bound
+		uint64_t elapsedMs = 0;
+		double getRate() const { return elapsedMs == 0 ? 0 : written * 1000.0 / elapsedMs; } // Presets per second
+		double getMegabytesPerSecond() const { return elapsedMs == 0 ? 0 : bytes / 1048576.0 * 1000.0 / elapsedMs; }
+	};
+	ExportProgress getExportProgress() const;
+
+	// Backend counters per operation as JSON: requests, bytes, retries, timing
+	bool exportBackendStats(const std::string & path);
+
 	// UI Parameters
 	ofParameter<bool> bConnected { "Connected", false };
 	ofParameter<bool> bRemoteMode { "Remote Mode", true };
@@ -62,52 +117,196 @@ public:
 	std::string getConnectionStatus() const;
 	bool isConnected() const { return bConnected; }
 
+	// Storage backend, from credentials.txt unless set before setup()
+	void setBackend(std::shared_ptr<ofxSurfingSupabaseBackend> backend);
+	std::shared_ptr<ofxSurfingSupabaseBackend> getBackend() const;
+	uint64_t getReplicationLagMillis(); // Oldest unpushed change or, local-first, time since the last pull
+
 private:
 	int selectedPresetIndexRemotePrev = -1;
 
-	// Configuration
-	struct SupabaseConfig {
-		std::string authMode;
-		std::string supabaseUrl;
-		std::string supabaseAnonKey;
-		std::string email;
-		std::string password;
-		bool isValid() const;
-	};
-
-	// HTTP Client
-	struct HttpResponse {
-		int statusCode;
-		std::string body;
-		bool success;
-	};
-
 	// Internal methods
 	void setupParameters();
 	void setupCallbacks();
 	void setupGui();
+	void setupCache();
+	void setupJournal();
+	void stopJournalThread();
 	void startup();
 
 	bool loadCredentials();
 	bool authenticate();
-
-	HttpResponse httpGet(const std::string & endpoint);
-	HttpResponse httpPost(const std::string & endpoint, const std::string & jsonBody);
-	HttpResponse httpDelete(const std::string & endpoint);
+	void setupSessionUser();
 
 	std::string serializeSceneToJson();
 	void deserializeJsonToScene(const std::string & jsonStr);
 
 	std::string generateTimestampName();
+	static std::string makeUniqueName(const std::string & baseName, const std::unordered_set<std::string> & takenNames);
+	static bool isNewerTimestamp(const std::string & a, const std::string & b);
+
+	// Incremental list sync, resolved in a worker and applied in update()
+	struct PresetListSync {
+		enum Type { FAILED, UNCHANGED, MERGE, RESET };
+		Type type = FAILED;
+		int generation = 0;
+		int remoteCount = -1;
+		std::string remoteNewest;
+		std::string watermark; // MERGE: newest updated_at of the changed rows
+		int page = -1; // RESET: page fetched under the selection
+		int pageTotal = -1;
+		std::vector<std::string> names; // MERGE: changed rows, RESET: names of the page
+		std::vector<std::string> changed; // MERGE: rows whose payload differs from the cached copy
+	};
+	void syncPresetListRemote(PresetListSync & sync, bool synced, bool complete, int localCount, const std::string & watermark, int page);
+	void applyPresetListSync(const PresetListSync & sync);
+	bool probePresetListRemote(int & remoteCount, std::string & remoteNewest);
+
+	// Paged list (Range header) and virtualized view
+	bool fetchPresetListPage(int page, std::vector<std::string> & names, int & total);
+	void applyPresetListPage(int page, const std::vector<std::string> & names, int total);
+	void requestPresetListPages(int indexFirst, int indexLast);
+	bool isPresetListComplete() const;
+	void resizePresetListPages();
+	void scrollPresetListTo(int index);
+	void clampPresetListScroll();
+
+	// Cached overlays
+	struct OverlayState {
+		bool connected = false;
+		bool loading = false;
+		bool saving = false;
+		int spinnerTick = -1;
+		int selected = -1;
+		int scrollOffset = 0;
+		int listRevision = -1;
+		int journalDepth = 0;
+		int journalRate = 0; // Tenths of ops/s
+		bool reachable = true;
+		bool localFirst = false;
+		int lagPush = 0; // Seconds
+		int lagPull = 0;
+		std::string backendName;
+		int backendLoad = 0; // Tenths of ms, average per call
+		int backendSave = 0;
+		int backendRetries = 0;
+		bool backendOpen = false; // A circuit breaker is failing fast
+		int backendQueued = 0; // Calls waiting for the scheduler
+		int backendRequests = 0;
+		int backendKbUp = 0;
+		int backendKbDown = 0;
+		int backendThrottled = 0; // Background calls refused by the rate limiter
+		int importFiles = 0;
+		int importDone = 0; // Uploaded, invalid or failed
+		int importRate = 0; // Tenths of presets/s
+		int exportTotal = 0;
+		int exportDone = 0; // Written or failed
+		int exportRate = 0; // Tenths of presets/s
+		bool operator!=(const OverlayState & o) const {
+			return connected != o.connected || loading != o.loading || saving != o.saving || spinnerTick != o.spinnerTick
+				|| selected != o.selected || scrollOffset != o.scrollOffset || listRevision != o.listRevision
+				|| journalDepth != o.journalDepth || journalRate != o.journalRate || reachable != o.reachable
+				|| localFirst != o.localFirst || lagPush != o.lagPush || lagPull != o.lagPull
+				|| backendName != o.backendName || backendLoad != o.backendLoad || backendSave != o.backendSave
+				|| backendRetries != o.backendRetries || backendOpen != o.backendOpen
+				|| backendQueued != o.backendQueued || backendRequests != o.backendRequests || backendKbUp != o.backendKbUp
+				|| backendKbDown != o.backendKbDown || backendThrottled != o.backendThrottled
+				|| importFiles != o.importFiles || importDone != o.importDone || importRate != o.importRate
+				|| exportTotal != o.exportTotal || exportDone != o.exportDone || exportRate != o.exportRate;
+		}
+	};
+	OverlayState getOverlayState();
+	void renderStatusPanel();
+	void renderKeysPanel();
+	void logBackendStats();
+
+	// Local list model: presetsNamesRemote patched by each mutation, indexed by name.
+	// Full re-fetches only on explicit refresh or when the probed row count diverges
+	int findPresetIndex(const std::string & name) const; // -1 when not listed or its page not loaded
+	void setPresetName(std::size_t index, const std::string & name);
+	void rebuildPresetIndex();
+	int countPresetNamesUnpushed(); // Still queued in the journal, so not counted by the remote yet
+	void mergePresetNamesUnpushed();
+
+	// Local list patching
+	void updateSelectedIndexRange();
+	std::string getSelectedIndexName() const; // Under the index, even while the selection waits for its page
+	void onPresetSaved(const ofxSurfingSupabaseBackend::Row & saved, const std::string & payload);
+
+	void patchPresetNameAdded(const std::string & name);
+	void patchPresetNamesRemoved(const std::vector<std::string> & names);
+
+	// Persistent cache
+	void saveCacheState();
+
+	// Write-ahead journal replay
+	enum ReplayResult {
+		REPLAY_DONE, // Acknowledge, sent or permanently rejected
+		REPLAY_RETRY // Keep and back off
+	};
+	std::string getJournalUserId() const;
+	void journalThreadFunction();
+	void setJournalSession(bool connected);
+	ReplayResult replayJournalEntry(const ofxSurfingSupabaseJournal::Entry & entry, const std::string & userId);
+	ReplayResult replayJournalDeletes(const std::string & userId, std::size_t & count); // The run of deletes at the front
+	ReplayResult replayJournalClear(const ofxSurfingSupabaseJournal::Entry & entry, const std::string & userId);
+	void applyDatabaseCleared();
+	ReplayResult replaySavePreset(ofxSurfingSupabaseBackend & backend, const ofxSurfingSupabaseJournal::Entry & entry);
+	ReplayResult replaySavePresetNew(ofxSurfingSupabaseBackend & backend, const ofxSurfingSupabaseJournal::Entry & entry, const ofJson & presetJson);
+	static ReplayResult getReplayResult(int statusCode);
+	void onPresetSaveDropped(const ofxSurfingSupabaseJournal::Entry & entry);
+	bool writeRemote(const ofxSurfingSupabaseJournal::Entry & entry, const std::vector<std::string> & names = {}); // Remote mode, no journal
+
+	// Local-first replication: pulls remote changes into the disk cache
+	struct ReplicaPull {
+		bool success = false;
+		std::string userId;
+		std::string watermark;
+		std::vector<std::string> names; // Rows written to the cache
+		std::vector<std::string> changed; // Written with a different payload
+		int skipped = 0; // Rows older than the local copy
+	};
+	void startReplicaPull();
+	void pullReplicaRemote(ReplicaPull & pull);
+	void applyReplicaPull(const ReplicaPull & pull);
+
+	// Bulk import
+	void importFolderThread(const std::vector<std::string> & paths, const ofJson & shape, int batchSize);
+	static bool isSceneShape(const ofJson & json, const ofJson & shape, std::string & mismatch);
+
+	// Bulk export
+	void exportPresetsThread(const std::string & folder, const std::string & bundlePath);
 
 	// State
-	SupabaseConfig config_;
-	std::string authToken_;
+	std::shared_ptr<ofxSurfingSupabaseBackend> backend_;
+	mutable std::mutex backendMutex_;
+	bool bBackendExternal_ = false;
 	std::string userId_;
 
-	ofParameterGroup * sceneParams_;
+	ofParameterGroup * sceneParams_ = nullptr;
 
 	std::vector<std::string> presetsNamesRemote;
+	std::unordered_map<std::string, int> presetIndexByName_; // Loaded names of presetsNamesRemote
+	std::unordered_set<std::string> presetNamesUnpushed_; // Listed by a local save the remote has not confirmed
+	std::string listWatermark_; // Max updated_at seen by the last list sync
+	std::string listUserId_; // Owner of presetsNamesRemote and the cache
+	bool listSynced_ = false;
+
+	// Unloaded pages keep empty names until fetched
+	struct PresetListPage {
+		int page;
+		int generation;
+		bool success;
+		int total;
+		std::vector<std::string> names;
+	};
+	std::vector<bool> presetListPagesLoaded_;
+	std::set<int> presetListPagesInFlight_;
+	int presetListGeneration_ = 0;
+	int listScrollOffset_ = 0;
+	bool bAutoLoadDeferred_ = false;
+	std::string selectedPresetName_; // The selection follows this preset across list changes
+	bool bSelectionMoving_ = false; // List changes move the index without auto loading
 
 	std::atomic<bool> isLoadingRemote_ { false };
 	std::atomic<bool> hasPendingPreset_ { false };
@@ -115,17 +314,87 @@ private:
 	std::string pendingPresetJson_;
 	std::string pendingPresetName_;
 	std::atomic<bool> isSavingRemote_{false};
-	std::atomic<bool> hasPendingPresetList_{false};
 	std::mutex pendingPresetListMutex_;
-	std::vector<std::string> pendingPresetList_;
+	std::atomic<bool> isRefreshingRemote_ { false };
+	std::atomic<bool> hasPendingPresetListSync_ { false };
+	PresetListSync pendingPresetListSync_;
+	bool bRefreshQueued_ = false;
+	std::atomic<bool> hasPendingPresetNamesAdded_ { false };
+	std::vector<std::string> pendingPresetNamesAdded_;
+	std::atomic<bool> hasPendingPresetNamesDropped_ { false };
+	std::vector<std::string> pendingPresetNamesDropped_; // Saves the remote rejected for good
+	std::atomic<bool> hasPendingPresetPages_ { false };
+	std::vector<PresetListPage> pendingPresetPages_;
+
+	// Disk cache
+	ofxSurfingSupabaseCache cache_;
+	int cacheStateRevision_ = -1;
+	int cacheStateSelected_ = -1;
+	float cacheStateTime_ = 0;
+
+	// Write-ahead journal
+	ofxSurfingSupabaseJournal journal_;
+	std::thread journalThread_;
+	std::atomic<bool> journalThreadRunning_ { false };
+	std::mutex journalMutex_;
+	std::condition_variable journalCondition_;
+	std::string journalUserId_; // Session user as seen by the worker, under journalMutex_
+	std::atomic<bool> journalConnected_ { false };
+	std::atomic<bool> bRemoteReachable_ { true };
+	std::atomic<double> journalReplayRate_ { 0 };
+	std::atomic<uint64_t> journalReplayed_ { 0 };
+	std::atomic<bool> hasPendingRefresh_ { false };
+	std::atomic<bool> hasPendingClear_ { false }; // A wipe was confirmed by the remote
+
+	// Local-first replication
+	std::string replicaWatermark_;
+	std::atomic<bool> isReplicatingRemote_ { false };
+	std::atomic<bool> hasPendingReplicaPull_ { false };
+	ReplicaPull pendingReplicaPull_;
+	uint64_t replicaPullAt_ = 0; // Next pull, ms
+	uint64_t replicaPullTime_ = 0; // Last successful pull, ms
+
+	// Bulk import
+	std::atomic<bool> isImporting_ { false };
+	std::atomic<int> importFiles_ { 0 };
+	std::atomic<int> importRead_ { 0 };
+	std::atomic<int> importInvalid_ { 0 };
+	std::atomic<int> importUploaded_ { 0 };
+	std::atomic<int> importFailed_ { 0 };
+	std::atomic<uint64_t> importBytes_ { 0 };
+	std::atomic<uint64_t> importTimeStart_ { 0 };
+	std::atomic<uint64_t> importTimeEnd_ { 0 };
+
+	// Bulk export
+	std::atomic<bool> isExporting_ { false };
+	std::atomic<int> exportTotal_ { -1 };
+	std::atomic<int> exportFetched_ { 0 };
+	std::atomic<int> exportWritten_ { 0 };
+	std::atomic<int> exportFailed_ { 0 };
+	std::atomic<uint64_t> exportBytes_ { 0 };
+	std::atomic<uint64_t> exportFetchMs_ { 0 };
+	std::atomic<int> exportQueuedPeak_ { 0 };
+	std::atomic<uint64_t> exportTimeStart_ { 0 };
+	std::atomic<uint64_t> exportTimeEnd_ { 0 };
 
 	// UI
 	ofxPanel gui_;
+	ofFbo statusPanelFbo_;
+	ofFbo keysPanelFbo_;
+	OverlayState statusPanelState_;
+	int presetListRevision_ = 0; // Bumped on every change to presetsNamesRemote
+	double overlayCostMicros_ = 0;
+	uint64_t overlayRenders_ = 0;
+	uint64_t overlayRefreshAt_ = 0; // Next poll of the overlay stats, ms
+	uint64_t overlayCostLabelAt_ = 0;
+	std::string overlayCostLabel_;
 	ofParameterGroup params_;
 	ofParameterGroup paramsManager_;
 
 	// Event listeners
 	ofEventListener e_vReconnect;
+	ofEventListener e_bRemoteMode;
+	ofEventListener e_bDebug;
 	ofEventListener e_vSaveToRemote;
 	ofEventListener e_vSaveNewRemote;
 	ofEventListener e_vLoadFromRemote;
@@ -138,5 +407,27 @@ private:
 
 	// Constants
 	static const std::string CREDENTIALS_PATH;
-	static const std::string TABLE_NAME;
+	static const std::string CACHE_PATH;
+	static const std::string JOURNAL_PATH;
+	static const std::string LOCAL_PATH;
+	static const std::string STATS_PATH;
+	static const int UNIQUE_NAME_ROUNDS_MAX = 3;
+	static const int LIST_PAGE_SIZE = 500;
+	static const int LIST_ROWS_VISIBLE = 20;
+	static const int JOURNAL_SYNC_MS = 100; // fsync batch window
+	static const int JOURNAL_RETRY_MIN_MS = 1000;
+	static const int JOURNAL_RETRY_MAX_MS = 30000;
+	static const int JOURNAL_DELETE_BATCH = 500; // Deletes sent together, split further by URL length
+	static const int REPLICA_PULL_INTERVAL_MS = 5000;
+	static const int REPLICA_BATCH_SIZE = 100;
+	static const int IMPORT_BATCH_DEFAULT = 100; // Rows per array POST
+	static const int IMPORT_READERS_MAX = 8;
+	static const int IMPORT_QUEUE_BATCHES = 4; // Read ahead of the upload
+	static const int EXPORT_PAGE_SIZE = 200; // Rows with payloads per list request
+	static const int EXPORT_WRITERS_MAX = 4;
+	static const int EXPORT_QUEUE_PAGES = 2; // Fetched ahead of the writers, bounds the memory
+	static const int OVERLAY_PADDING = 5;
+	static const int OVERLAY_LINE_OFFSET = 15; // Bitmap text baseline from the line top
+	static const int OVERLAY_REFRESH_MS = 250; // Stats poll, and the spinner step
+	static const int OVERLAY_COST_LABEL_MS = 500;
 };
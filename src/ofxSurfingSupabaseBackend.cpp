@@ -0,0 +1,656 @@
+#include "ofxSurfingSupabaseBackend.h"
+
+#include "ofMain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <random>
+#include <thread>
+
+namespace {
+
+thread_local ofxSurfingSupabaseBackend::Priority currentPriority = ofxSurfingSupabaseBackend::PRIORITY_INTERACTIVE;
+
+uint64_t getSteadyMicros() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t getSteadyMillis() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::connect() {
+	std::string userId;
+	bool ok = doConnect(userId);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		userId_ = ok ? userId : "";
+	}
+	connected_ = ok;
+
+	return ok;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackend::getUserId() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return userId_;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::ScopedPriority::ScopedPriority(Priority priority)
+	: previous_(currentPriority) {
+	currentPriority = priority;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::ScopedPriority::~ScopedPriority() {
+	currentPriority = previous_;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::call(Op op, const std::function<Result()> & function) {
+	std::atomic<int> priority { currentPriority };
+	return call(op, function, priority);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::call(Op op, const std::function<Result()> & function, std::atomic<int> & priority) {
+	if (!connected_) {
+		Result result;
+		result.error = "Not connected";
+		return result;
+	}
+
+	RetryPolicy policy = getRetryPolicy(op);
+
+	// Over budget: background work gives way before touching the breaker
+	int retryAfterMs = -1;
+	if (!acquireToken(op, priority, retryAfterMs)) {
+		stats_[op].throttled++;
+		Result result;
+		result.status = 429;
+		result.error = "Rate limited";
+		result.retryAfterMs = retryAfterMs;
+		result.throttled = true;
+		return result;
+	}
+
+	// Fail fast while the store is known to be down
+	if (!acquireBreaker(op, policy)) {
+		stats_[op].rejected++;
+		Result result;
+		result.error = "Circuit open";
+		return result;
+	}
+
+	int slot = admit(priority);
+
+	auto timeStart = std::chrono::steady_clock::now();
+	Result result;
+	for (int attempt = 0;; ++attempt) {
+		result = function();
+		stats_[op].requests += result.requests;
+		stats_[op].bytesSent += result.bytesSent;
+		stats_[op].bytesReceived += result.bytesReceived;
+		if (!isTransient(result) || attempt >= policy.maxRetries) break;
+
+		int delay = getRetryDelay(policy, attempt, result.retryAfterMs);
+		if (delay < 0) break; // Asked to wait longer than the policy allows
+
+		stats_[op].retries++;
+		if (bDebug_) {
+			ofLogNotice("ofxSurfingSupabaseBackend") << getOpName(op) << "(): HTTP " << result.status << ", retry " << (attempt + 1) << " in " << delay << " ms";
+		}
+
+		// Backing off frees the slot: more urgent work goes first
+		dismiss(slot);
+		std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+		if (!acquireToken(op, priority, retryAfterMs)) {
+			stats_[op].throttled++;
+			result = Result();
+			result.status = 429;
+			result.error = "Rate limited";
+			result.retryAfterMs = retryAfterMs;
+			result.throttled = true;
+			slot = -1;
+			break;
+		}
+		slot = admit(priority);
+	}
+	if (slot >= 0) dismiss(slot);
+	auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - timeStart).count();
+
+	// A retry refused locally ends the call without a verdict on the store
+	if (result.throttled) {
+		cancelBreaker(op, policy);
+	} else {
+		releaseBreaker(op, policy, isTransient(result));
+	}
+
+	stats_[op].calls++;
+	stats_[op].micros += static_cast<uint64_t>(micros);
+	if (!result.success) stats_[op].failures++;
+
+	return result;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::callShared(Op op, const std::string & key, const std::function<void(Flight &, std::atomic<int> &)> & function, Flight & out) {
+	std::shared_ptr<SharedFlight> shared;
+	bool leader = false;
+	{
+		std::lock_guard<std::mutex> lock(flightMutex_);
+		auto it = flights_.find(key);
+		if (it != flights_.end()) {
+			shared = it->second;
+		} else {
+			shared = std::make_shared<SharedFlight>();
+			shared->priority = currentPriority;
+			flights_[key] = shared;
+			leader = true;
+		}
+	}
+
+	if (leader) {
+		// Waiters must always be released
+		try {
+			function(shared->flight, shared->priority);
+		} catch (std::exception & e) {
+			shared->flight.result = Result { 0, false, e.what() };
+		}
+		{
+			std::lock_guard<std::mutex> lock(flightMutex_);
+			shared->done = true;
+			flights_.erase(key);
+		}
+		flightCondition_.notify_all();
+	} else {
+		stats_[op].shared++;
+
+		// A deferred prefetch must not hold an interactive load back
+		{
+			std::lock_guard<std::mutex> lock(schedulerMutex_);
+			if (currentPriority < shared->priority) shared->priority = currentPriority;
+		}
+		schedulerCondition_.notify_all();
+
+		std::unique_lock<std::mutex> lock(flightMutex_);
+		flightCondition_.wait(lock, [&shared]() { return shared->done; });
+	}
+
+	// Read only once done, so every waiter copies concurrently
+	out = shared->flight;
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackend::admit(std::atomic<int> & priority) {
+	std::unique_lock<std::mutex> lock(schedulerMutex_);
+	int slot = priority;
+	waiting_[slot]++;
+
+	while (true) {
+		// Lifted by a more urgent caller meanwhile
+		int now = priority;
+		if (now != slot) {
+			waiting_[slot]--;
+			waiting_[now]++;
+			slot = now;
+		}
+		if (canStart(slot)) break;
+		schedulerCondition_.wait(lock);
+	}
+
+	waiting_[slot]--;
+	running_[slot]++;
+	return slot;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::dismiss(int priority) {
+	{
+		std::lock_guard<std::mutex> lock(schedulerMutex_);
+		running_[priority]--;
+	}
+	schedulerCondition_.notify_all();
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::canStart(int priority) const {
+	// Callers hold schedulerMutex_
+	if (running_[priority] >= limits_[priority]) return false;
+
+	for (int i = 0; i < priority; ++i) {
+		if (waiting_[i] > 0) return false;
+	}
+
+	// Background work stays off the link while the user waits for a load
+	if (priority >= PRIORITY_PREFETCH && running_[PRIORITY_INTERACTIVE] > 0) return false;
+
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::isTransient(const Result & result) const {
+	return result.status == 0 || result.status == 408 || result.status == 429 || result.status >= 500;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::acquireBreaker(Op op, const RetryPolicy & policy) {
+	if (policy.breakerThreshold <= 0) return true;
+
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	Breaker & breaker = breakers_[op];
+	if (breaker.failures < policy.breakerThreshold) return true; // Closed
+
+	// Open: wait out the cooldown, then half open with one trial call
+	if (getSteadyMillis() < breaker.openUntil || breaker.trial) return false;
+	breaker.trial = true;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::releaseBreaker(Op op, const RetryPolicy & policy, bool failed) {
+	if (policy.breakerThreshold <= 0) return;
+
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	Breaker & breaker = breakers_[op];
+	if (!failed) {
+		if (breaker.failures >= policy.breakerThreshold) {
+			ofLogNotice("ofxSurfingSupabaseBackend") << getOpName(op) << "(): ✓ Circuit closed";
+		}
+		breaker.failures = 0;
+		breaker.trial = false;
+		return;
+	}
+
+	breaker.failures++;
+	if (breaker.failures >= policy.breakerThreshold) {
+		if (breaker.trial || breaker.failures == policy.breakerThreshold) {
+			ofLogWarning("ofxSurfingSupabaseBackend") << getOpName(op) << "(): ✗ Circuit open for " << policy.breakerCooldownMs << " ms";
+		}
+		breaker.openUntil = getSteadyMillis() + policy.breakerCooldownMs;
+	}
+	breaker.trial = false;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::cancelBreaker(Op op, const RetryPolicy & policy) {
+	if (policy.breakerThreshold <= 0) return;
+
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	breakers_[op].trial = false;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::acquireToken(Op op, int priority, int & retryAfterMs) {
+	double waitMs;
+	{
+		std::lock_guard<std::mutex> lock(rateMutex_);
+		Bucket & bucket = buckets_[isWrite(op) ? 1 : 0];
+		if (bucket.limit.perSecond <= 0) return true;
+
+		uint64_t now = getSteadyMicros();
+		bucket.tokens = std::min(bucket.limit.burst, bucket.tokens + (now - bucket.refilledAt) / 1e6 * bucket.limit.perSecond);
+		bucket.refilledAt = now;
+
+		if (priority >= PRIORITY_PREFETCH) {
+			if (bucket.tokens < 1 + bucket.limit.burst * RATE_RESERVE) {
+				retryAfterMs = static_cast<int>(std::ceil((1 + bucket.limit.burst * RATE_RESERVE - bucket.tokens) / bucket.limit.perSecond * 1000));
+				return false;
+			}
+			bucket.tokens -= 1;
+			return true;
+		}
+
+		// Taken on credit: foreground callers queue up behind each other
+		bucket.tokens -= 1;
+		if (bucket.tokens >= 0) return true;
+		waitMs = -bucket.tokens / bucket.limit.perSecond * 1000;
+	}
+
+	if (bDebug_) {
+		ofLogNotice("ofxSurfingSupabaseBackend") << getOpName(op) << "(): Rate limited, waiting " << ofToString(waitMs, 0) << " ms";
+	}
+	std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(waitMs * 1000)));
+	return true;
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackend::getRetryDelay(const RetryPolicy & policy, int attempt, int retryAfterMs) {
+	thread_local std::mt19937 generator(std::random_device {}());
+
+	if (retryAfterMs >= 0) {
+		if (retryAfterMs > policy.maxDelayMs) return -1;
+		// A little spread, so clients told the same time do not return together
+		return retryAfterMs + std::uniform_int_distribution<int>(0, policy.baseDelayMs)(generator);
+	}
+
+	// Full jitter over the exponential ceiling
+	int64_t ceiling = std::min<int64_t>(policy.maxDelayMs, static_cast<int64_t>(policy.baseDelayMs) << std::min(attempt, 20));
+	return std::uniform_int_distribution<int>(0, static_cast<int>(ceiling))(generator);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::load(const std::string & name, const std::string & updatedAfter, Row & row) {
+	Flight flight;
+	callShared(OP_LOAD, "load\n" + name + "\n" + updatedAfter, [&](Flight & f, std::atomic<int> & priority) {
+		Row found;
+		f.result = call(OP_LOAD, [&]() { return doLoad(name, updatedAfter, found); }, priority);
+		if (!found.name.empty()) f.rows.push_back(std::move(found));
+	}, flight);
+
+	row = flight.rows.empty() ? Row() : std::move(flight.rows.front());
+	return flight.result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::save(const Row & row, bool overwrite, Row & saved) {
+	return call(OP_SAVE, [&]() { return doSave(row, overwrite, saved); });
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::remove(const std::string & name) {
+	return call(OP_REMOVE, [&]() { return doRemove(name); });
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::list(const Query & query, std::vector<Row> & rows, int & total) {
+	std::string key = "list\n" + query.updatedAfter + "\n" + query.namePrefix + "\n" + std::to_string(query.withData) + std::to_string(query.byUpdated)
+		+ std::to_string(query.count) + "\n" + std::to_string(query.offset) + "\n" + std::to_string(query.limit);
+
+	Flight flight;
+	callShared(OP_LIST, key, [&](Flight & f, std::atomic<int> & priority) {
+		f.result = call(OP_LIST, [&]() { return doList(query, f.rows, f.number); }, priority);
+	}, flight);
+
+	rows.insert(rows.end(), std::make_move_iterator(flight.rows.begin()), std::make_move_iterator(flight.rows.end()));
+	total = flight.number;
+	return flight.result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::listEach(const Query & query, const std::function<void(Row &)> & onRow, int & total) {
+	// Rows already handed over are skipped when a retry streams the page again
+	int delivered = 0;
+	return call(OP_LIST, [&]() {
+		int skip = delivered;
+		return doListEach(query, [&](Row & row) {
+			if (skip > 0) {
+				skip--;
+				return;
+			}
+			delivered++;
+			onRow(row);
+		}, total);
+	});
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::doListEach(const Query & query, const std::function<void(Row &)> & onRow, int & total) {
+	std::vector<Row> rows;
+	Result result = doList(query, rows, total);
+	if (result.success) {
+		for (auto & row : rows) {
+			onRow(row);
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::probe(int & count, std::string & newest) {
+	Flight flight;
+	callShared(OP_PROBE, "probe", [&](Flight & f, std::atomic<int> & priority) {
+		f.result = call(OP_PROBE, [&]() { return doProbe(f.number, f.text); }, priority);
+	}, flight);
+
+	count = flight.number;
+	newest = std::move(flight.text);
+	return flight.result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::loadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) {
+	Result result { 200, true, "" };
+	for (auto & chunk : splitNames(names)) {
+		std::string key = "load bulk";
+		for (auto & name : chunk) key += "\n" + name;
+
+		Flight flight;
+		callShared(OP_LOAD_BULK, key, [&](Flight & f, std::atomic<int> & priority) {
+			f.result = call(OP_LOAD_BULK, [&]() { return doLoadBulk(chunk, f.rows); }, priority);
+		}, flight);
+
+		result = flight.result;
+		if (!result.success) break;
+		rows.insert(rows.end(), std::make_move_iterator(flight.rows.begin()), std::make_move_iterator(flight.rows.end()));
+	}
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::saveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) {
+	return call(OP_SAVE_BULK, [&]() { return doSaveBulk(rows, overwrite, saved); });
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::removeBulk(const std::vector<std::string> & names) {
+	Result result { 200, true, "" };
+	for (auto & chunk : splitNames(names)) {
+		result = call(OP_REMOVE_BULK, [&]() { return doRemoveBulk(chunk); });
+		if (!result.success) break;
+	}
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackend::removeAll() {
+	return call(OP_REMOVE_BULK, [&]() { return doRemoveAll(); });
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::loadAsync(const std::string & name, const std::string & updatedAfter, std::function<void(const Result &, const Row &)> callback, Priority priority) {
+	// The worker keeps the backend alive until it returns
+	auto self = shared_from_this();
+	std::thread([self, name, updatedAfter, callback, priority]() {
+		ScopedPriority scope(priority);
+		Row row;
+		Result result = self->load(name, updatedAfter, row);
+		if (callback) callback(result, row);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::saveAsync(const Row & row, bool overwrite, std::function<void(const Result &, const Row &)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, row, overwrite, callback, priority]() {
+		ScopedPriority scope(priority);
+		Row saved;
+		Result result = self->save(row, overwrite, saved);
+		if (callback) callback(result, saved);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::removeAsync(const std::string & name, std::function<void(const Result &)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, name, callback, priority]() {
+		ScopedPriority scope(priority);
+		Result result = self->remove(name);
+		if (callback) callback(result);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::listAsync(const Query & query, std::function<void(const Result &, const std::vector<Row> &, int)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, query, callback, priority]() {
+		ScopedPriority scope(priority);
+		std::vector<Row> rows;
+		int total = -1;
+		Result result = self->list(query, rows, total);
+		if (callback) callback(result, rows, total);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::loadBulkAsync(const std::vector<std::string> & names, std::function<void(const Result &, const std::vector<Row> &)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, names, callback, priority]() {
+		ScopedPriority scope(priority);
+		std::vector<Row> rows;
+		Result result = self->loadBulk(names, rows);
+		if (callback) callback(result, rows);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::saveBulkAsync(const std::vector<Row> & rows, bool overwrite, std::function<void(const Result &, const std::vector<Row> &)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, rows, overwrite, callback, priority]() {
+		ScopedPriority scope(priority);
+		std::vector<Row> saved;
+		Result result = self->saveBulk(rows, overwrite, saved);
+		if (callback) callback(result, saved);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::removeBulkAsync(const std::vector<std::string> & names, std::function<void(const Result &)> callback, Priority priority) {
+	auto self = shared_from_this();
+	std::thread([self, names, callback, priority]() {
+		ScopedPriority scope(priority);
+		Result result = self->removeBulk(names);
+		if (callback) callback(result);
+	}).detach();
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Stats ofxSurfingSupabaseBackend::getStats(Op op) const {
+	Stats stats;
+	stats.calls = stats_[op].calls;
+	stats.failures = stats_[op].failures;
+	stats.micros = stats_[op].micros;
+	stats.retries = stats_[op].retries;
+	stats.rejected = stats_[op].rejected;
+	stats.shared = stats_[op].shared;
+	stats.throttled = stats_[op].throttled;
+	stats.requests = stats_[op].requests;
+	stats.bytesSent = stats_[op].bytesSent;
+	stats.bytesReceived = stats_[op].bytesReceived;
+	return stats;
+}
+
+//--------------------------------------------------------------
+std::vector<std::vector<std::string>> ofxSurfingSupabaseBackend::splitNames(const std::vector<std::string> & names) const {
+	if (names.empty()) return {};
+	return { names };
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::setRetryPolicy(Op op, const RetryPolicy & policy) {
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	policies_[op] = policy;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::RetryPolicy ofxSurfingSupabaseBackend::getRetryPolicy(Op op) const {
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	return policies_[op];
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::isBreakerOpen(Op op) const {
+	std::lock_guard<std::mutex> lock(retryMutex_);
+	return policies_[op].breakerThreshold > 0 && breakers_[op].failures >= policies_[op].breakerThreshold;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackend::getOpName(Op op) {
+	static const char * names[OP_COUNT] = { "load", "save", "remove", "list", "probe", "load bulk", "save bulk", "remove bulk" };
+	return (op >= 0 && op < OP_COUNT) ? names[op] : "";
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::setConcurrencyLimit(Priority priority, int limit) {
+	{
+		std::lock_guard<std::mutex> lock(schedulerMutex_);
+		limits_[priority] = std::max(1, limit);
+	}
+	schedulerCondition_.notify_all();
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackend::getRunning(Priority priority) const {
+	std::lock_guard<std::mutex> lock(schedulerMutex_);
+	return running_[priority];
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackend::getWaiting(Priority priority) const {
+	std::lock_guard<std::mutex> lock(schedulerMutex_);
+	return waiting_[priority];
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackend::setRateLimits(const RateLimit & reads, const RateLimit & writes) {
+	std::lock_guard<std::mutex> lock(rateMutex_);
+	const RateLimit limits[2] = { reads, writes };
+	for (int i = 0; i < 2; ++i) {
+		buckets_[i].limit = limits[i];
+		buckets_[i].limit.burst = std::max(1.0, limits[i].burst);
+		buckets_[i].tokens = buckets_[i].limit.burst; // Start full
+		buckets_[i].refilledAt = getSteadyMicros();
+	}
+}
+
+//--------------------------------------------------------------
+double ofxSurfingSupabaseBackend::getRateBudget(bool write) const {
+	std::lock_guard<std::mutex> lock(rateMutex_);
+	const Bucket & bucket = buckets_[write ? 1 : 0];
+	if (bucket.limit.perSecond <= 0) return 0;
+	double tokens = bucket.tokens + (getSteadyMicros() - bucket.refilledAt) / 1e6 * bucket.limit.perSecond;
+	return std::min(bucket.limit.burst, tokens);
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackend::isWrite(Op op) {
+	return op == OP_SAVE || op == OP_REMOVE || op == OP_SAVE_BULK || op == OP_REMOVE_BULK;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Priority ofxSurfingSupabaseBackend::getCurrentPriority() {
+	return currentPriority;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackend::getPriorityName(Priority priority) {
+	static const char * names[PRIORITY_COUNT] = { "load", "save", "list", "prefetch", "sync" };
+	return (priority >= 0 && priority < PRIORITY_COUNT) ? names[priority] : "";
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackend::makeTimestamp() {
+	auto now = std::chrono::system_clock::now();
+	std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+	int micros = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count() % 1000000);
+
+	std::tm utc;
+#ifdef _WIN32
+	gmtime_s(&utc, &seconds);
+#else
+	gmtime_r(&seconds, &utc);
+#endif
+
+	char buffer[40];
+	std::size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+	std::snprintf(buffer + n, sizeof(buffer) - n, ".%06d+00:00", micros);
+	return buffer;
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+	Storage backend interface.
+
+	A backend stores the presets of one user as rows of
+	(name, updated_at, payload) in creation order.
+	The blocking methods are thread-safe and meant for worker threads,
+	the async variants run them on a detached worker and call back from it.
+	Results use HTTP status codes: 0 when the store is unreachable,
+	409 when an insert hits an existing name.
+
+	Every call is timed per operation, so the backend cost (the network for
+	Supabase) can be told apart from the addon's own overhead.
+
+	Transient failures (unreachable, 408, 429, 5xx) are retried with
+	exponential backoff and full jitter, honouring Retry-After.
+	After a run of them a per operation circuit breaker fails fast until a
+	cooldown passes, then lets a single trial call through.
+
+	Reads are single-flight: a load, list, probe or bulk load identical to
+	one already in flight waits for it and shares its result instead of
+	issuing its own request. listEach() streams rows to a callback as they
+	arrive and is never shared; a retry skips the rows already handed over.
+
+	Calls are admitted by priority class, taken from the calling thread
+	(ScopedPriority) or given to the async variants. Each class has its
+	own concurrency limit, a class waits while a more urgent one is queued,
+	and prefetch and replication also wait while interactive loads run.
+	Retry backoffs give the slot up, so they are the preemption points.
+	A read joining a shared flight lifts the flight to its own priority.
+
+	Requests draw from a read or a write token bucket. Foreground classes
+	wait for their token; prefetch and replication only take one while the
+	bucket holds more than a reserve, else they fail at once (status 429,
+	counted as throttled) and retry on their own schedule. A refusal says
+	nothing about the store, so it never moves the circuit breaker.
+	Requests and wire bytes are counted per operation.
+*/
+
+class ofxSurfingSupabaseBackend : public std::enable_shared_from_this<ofxSurfingSupabaseBackend> {
+public:
+	struct Row {
+		std::string name;
+		std::string updatedAt;
+		std::string payload; // preset_data as JSON text, empty when not requested
+	};
+
+	struct Query {
+		std::string updatedAfter; // Only rows with a newer updated_at, empty for all
+		std::string namePrefix; // Only names starting with it
+		bool withData = false; // Include payloads
+		bool byUpdated = false; // Order by updated_at instead of creation
+		bool count = false; // Report the total of matching rows
+		int offset = 0;
+		int limit = -1; // -1 for all
+	};
+
+	struct Result {
+		int status = 0;
+		bool success = false;
+		std::string error; // Response body or reason, for debug logs
+		int retryAfterMs = -1; // Server asked to wait this long, -1 when not
+		int requests = 0; // Sent to the network, with the bytes of their paths and bodies
+		uint64_t bytesSent = 0;
+		uint64_t bytesReceived = 0;
+		bool throttled = false; // Refused by the local rate limiter, never reached the store
+	};
+
+	enum Op {
+		OP_LOAD = 0,
+		OP_SAVE,
+		OP_REMOVE,
+		OP_LIST,
+		OP_PROBE,
+		OP_LOAD_BULK,
+		OP_SAVE_BULK,
+		OP_REMOVE_BULK,
+		OP_COUNT
+	};
+
+	// Most urgent first
+	enum Priority {
+		PRIORITY_INTERACTIVE = 0, // Loading the selected preset
+		PRIORITY_SAVE, // User saves and deletes
+		PRIORITY_LIST, // Preset list refresh
+		PRIORITY_PREFETCH,
+		PRIORITY_REPLICATION, // Background sync
+		PRIORITY_COUNT
+	};
+
+	// Priority of the backend calls made by this thread while in scope
+	class ScopedPriority {
+	public:
+		explicit ScopedPriority(Priority priority);
+		~ScopedPriority();
+
+	private:
+		Priority previous_;
+	};
+
+	struct Stats {
+		uint64_t calls = 0;
+		uint64_t failures = 0;
+		uint64_t micros = 0;
+		uint64_t retries = 0;
+		uint64_t rejected = 0; // Failed fast by the open breaker
+		uint64_t shared = 0; // Served by an identical read already in flight
+		uint64_t throttled = 0; // Background calls refused by the rate limiter
+		uint64_t requests = 0;
+		uint64_t bytesSent = 0;
+		uint64_t bytesReceived = 0;
+		double getAverageMillis() const { return calls == 0 ? 0 : micros / 1000.0 / calls; }
+		double getDedupRatio() const { return calls + shared == 0 ? 0 : double(shared) / (calls + shared); }
+	};
+
+	struct CompressionStats {
+		uint64_t sentRaw = 0; // Bodies compressed before sending, and their wire size
+		uint64_t sentWire = 0;
+		uint64_t receivedRaw = 0; // Compressed responses, inflated and wire size
+		uint64_t receivedWire = 0;
+		uint64_t micros = 0; // CPU time in the codec
+		double getSentRatio() const { return sentWire == 0 ? 0 : double(sentRaw) / sentWire; }
+		double getReceivedRatio() const { return receivedWire == 0 ? 0 : double(receivedRaw) / receivedWire; }
+	};
+
+	struct TlsStats {
+		uint64_t requests = 0;
+		uint64_t fullHandshakes = 0;
+		uint64_t resumedHandshakes = 0; // From a session ticket
+		uint64_t fullMicros = 0;
+		uint64_t resumedMicros = 0;
+		double getFullMillis() const { return fullHandshakes == 0 ? 0 : fullMicros / 1000.0 / fullHandshakes; }
+		// Against a full handshake on every request
+		double getSavedMillisPerRequest() const {
+			return requests == 0 ? 0 : getFullMillis() - (fullMicros + resumedMicros) / 1000.0 / requests;
+		}
+	};
+
+	struct RetryPolicy {
+		int maxRetries = 2;
+		int baseDelayMs = 200;
+		int maxDelayMs = 4000; // Also the longest Retry-After waited for
+		int breakerThreshold = 5; // Consecutive transient failures to open, 0 disables the breaker
+		int breakerCooldownMs = 15000;
+	};
+
+	struct RateLimit {
+		double perSecond = 0; // 0 for no limit
+		double burst = 1; // Bucket size
+	};
+
+	virtual ~ofxSurfingSupabaseBackend() = default;
+
+	virtual std::string getName() const = 0;
+
+	// Session
+	bool connect();
+	bool isConnected() const { return connected_; }
+	std::string getUserId() const;
+
+	// Single presets
+	Result load(const std::string & name, const std::string & updatedAfter, Row & row); // Empty row when missing or not newer
+	Result save(const Row & row, bool overwrite, Row & saved);
+	Result remove(const std::string & name);
+
+	// Listing
+	Result list(const Query & query, std::vector<Row> & rows, int & total); // Total is -1 when not counted
+	Result listEach(const Query & query, const std::function<void(Row &)> & onRow, int & total); // One row in memory at a time
+	Result probe(int & count, std::string & newest); // Row count and newest updated_at
+
+	// Bulk, chunked by splitNames()
+	Result loadBulk(const std::vector<std::string> & names, std::vector<Row> & rows);
+	Result saveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved);
+	Result removeBulk(const std::vector<std::string> & names);
+	Result removeAll();
+
+	// Async
+	void loadAsync(const std::string & name, const std::string & updatedAfter, std::function<void(const Result &, const Row &)> callback, Priority priority = PRIORITY_INTERACTIVE);
+	void saveAsync(const Row & row, bool overwrite, std::function<void(const Result &, const Row &)> callback, Priority priority = PRIORITY_SAVE);
+	void removeAsync(const std::string & name, std::function<void(const Result &)> callback, Priority priority = PRIORITY_SAVE);
+	void listAsync(const Query & query, std::function<void(const Result &, const std::vector<Row> &, int)> callback, Priority priority = PRIORITY_LIST);
+	void loadBulkAsync(const std::vector<std::string> & names, std::function<void(const Result &, const std::vector<Row> &)> callback, Priority priority = PRIORITY_PREFETCH);
+	void saveBulkAsync(const std::vector<Row> & rows, bool overwrite, std::function<void(const Result &, const std::vector<Row> &)> callback, Priority priority = PRIORITY_SAVE);
+	void removeBulkAsync(const std::vector<std::string> & names, std::function<void(const Result &)> callback, Priority priority = PRIORITY_SAVE);
+
+	// Timing
+	Stats getStats(Op op) const;
+	static std::string getOpName(Op op);
+
+	// Retries
+	void setRetryPolicy(Op op, const RetryPolicy & policy);
+	RetryPolicy getRetryPolicy(Op op) const;
+	bool isBreakerOpen(Op op) const;
+
+	// Scheduling
+	void setConcurrencyLimit(Priority priority, int limit);
+	int getRunning(Priority priority) const;
+	int getWaiting(Priority priority) const;
+	static Priority getCurrentPriority(); // Of the calling thread, interactive by default
+	static std::string getPriorityName(Priority priority);
+
+	// Rate limiting
+	void setRateLimits(const RateLimit & reads, const RateLimit & writes);
+	double getRateBudget(bool write) const; // Tokens left, negative while callers wait
+	static bool isWrite(Op op);
+
+	// Transport compression, all zero when the backend does not compress
+	virtual CompressionStats getCompressionStats() const { return CompressionStats(); }
+	// Connection reuse, all zero when the backend has no connections
+	virtual TlsStats getTlsStats() const { return TlsStats(); }
+
+	void setDebug(bool b) { bDebug_ = b; }
+
+	// UTC in the PostgREST timestamptz shape, e.g. 2025-01-19T10:20:30.123456+00:00
+	static std::string makeTimestamp();
+
+protected:
+	virtual bool doConnect(std::string & userId) = 0;
+	virtual Result doLoad(const std::string & name, const std::string & updatedAfter, Row & row) = 0;
+	virtual Result doSave(const Row & row, bool overwrite, Row & saved) = 0;
+	virtual Result doRemove(const std::string & name) = 0;
+	virtual Result doList(const Query & query, std::vector<Row> & rows, int & total) = 0;
+	virtual Result doListEach(const Query & query, const std::function<void(Row &)> & onRow, int & total); // doList, then row by row
+	virtual Result doProbe(int & count, std::string & newest) = 0;
+	virtual Result doLoadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) = 0;
+	virtual Result doSaveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) = 0;
+	virtual Result doRemoveBulk(const std::vector<std::string> & names) = 0;
+	virtual Result doRemoveAll() = 0;
+
+	// Worth another attempt
+	virtual bool isTransient(const Result & result) const;
+
+	// Bulk loads and removes go out one call per chunk, to stay within the
+	// request limits of the store. A single chunk by default
+	virtual std::vector<std::vector<std::string>> splitNames(const std::vector<std::string> & names) const;
+
+	std::atomic<bool> bDebug_ { false };
+
+private:
+	// Outputs of a shared read, whichever fields the op fills
+	struct Flight {
+		Result result;
+		std::vector<Row> rows;
+		int number = -1;
+		std::string text;
+	};
+
+	struct SharedFlight {
+		Flight flight;
+		std::atomic<int> priority; // Most urgent of the callers, guarded by schedulerMutex_ for writes
+		bool done = false;
+	};
+
+	Result call(Op op, const std::function<Result()> & function);
+	Result call(Op op, const std::function<Result()> & function, std::atomic<int> & priority);
+	void callShared(Op op, const std::string & key, const std::function<void(Flight &, std::atomic<int> &)> & function, Flight & out);
+	int admit(std::atomic<int> & priority); // Blocks, returns the class it runs as
+	void dismiss(int priority);
+	bool canStart(int priority) const;
+	bool acquireBreaker(Op op, const RetryPolicy & policy);
+	void releaseBreaker(Op op, const RetryPolicy & policy, bool failed);
+	void cancelBreaker(Op op, const RetryPolicy & policy); // No verdict: gives a half open trial back
+	static int getRetryDelay(const RetryPolicy & policy, int attempt, int retryAfterMs);
+	bool acquireToken(Op op, int priority, int & retryAfterMs); // Blocks in the foreground
+
+	std::atomic<bool> connected_ { false };
+	mutable std::mutex mutex_;
+	std::string userId_;
+
+	struct AtomicStats {
+		std::atomic<uint64_t> calls { 0 };
+		std::atomic<uint64_t> failures { 0 };
+		std::atomic<uint64_t> micros { 0 };
+		std::atomic<uint64_t> retries { 0 };
+		std::atomic<uint64_t> rejected { 0 };
+		std::atomic<uint64_t> shared { 0 };
+		std::atomic<uint64_t> throttled { 0 };
+		std::atomic<uint64_t> requests { 0 };
+		std::atomic<uint64_t> bytesSent { 0 };
+		std::atomic<uint64_t> bytesReceived { 0 };
+	};
+	AtomicStats stats_[OP_COUNT];
+
+	struct Breaker {
+		int failures = 0; // Consecutive transient ones
+		uint64_t openUntil = 0; // Steady clock ms
+		bool trial = false; // Half open call in flight
+	};
+	mutable std::mutex retryMutex_;
+	RetryPolicy policies_[OP_COUNT];
+	Breaker breakers_[OP_COUNT];
+
+	std::mutex flightMutex_;
+	std::condition_variable flightCondition_;
+	std::unordered_map<std::string, std::shared_ptr<SharedFlight>> flights_; // By op and arguments
+
+	mutable std::mutex schedulerMutex_;
+	std::condition_variable schedulerCondition_;
+	int limits_[PRIORITY_COUNT] = { 4, 2, 1, 2, 1 };
+	int running_[PRIORITY_COUNT] = {};
+	int waiting_[PRIORITY_COUNT] = {};
+
+	struct Bucket {
+		RateLimit limit;
+		double tokens = 0;
+		uint64_t refilledAt = 0; // Steady clock us
+	};
+	mutable std::mutex rateMutex_;
+	Bucket buckets_[2]; // Reads, writes
+	static constexpr double RATE_RESERVE = 0.5; // Of the burst, kept for the foreground
+};
@@ -0,0 +1,398 @@
+#include "ofxSurfingSupabaseBackendLocal.h"
+
+#include "ofMain.h"
+
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace {
+
+const std::string FILE_EXTENSION = ".json";
+
+// Parses a JSON file straight from its memory mapping, no read copy
+bool parseMapped(const std::string & path, ofJson & json) {
+	const char * data = nullptr;
+	std::size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void * view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	data = static_cast<const char *>(view);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	size = static_cast<std::size_t>(info.st_size);
+
+	void * view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (view == MAP_FAILED) {
+		::close(fd);
+		return false;
+	}
+	data = static_cast<const char *>(view);
+#endif
+
+	bool ok = true;
+	try {
+		json = ofJson::parse(data, data + size);
+	} catch (std::exception & e) {
+		ofLogWarning("ofxSurfingSupabaseBackendLocal") << "parseMapped(): " << path << ": " << e.what();
+		ok = false;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+	CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	munmap(view, size);
+	::close(fd);
+#endif
+
+	return ok;
+}
+
+// Write to a temporary file, then rename over the target
+bool writeAtomic(const std::string & path, const std::string & text) {
+	std::string pathTemp = path + ".tmp";
+	{
+		std::ofstream file(pathTemp, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+		file.write(text.data(), text.size());
+		if (!file) return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(pathTemp, path, ec);
+	return !ec;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendLocal::ofxSurfingSupabaseBackendLocal(const std::string & folder)
+	: folder_(folder) {
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendLocal::doConnect(std::string & userId) {
+	ofLogNotice("ofxSurfingSupabaseBackendLocal") << "connect(): " << folder_;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!ofDirectory::doesDirectoryExist(folder_, false)) {
+		if (!ofDirectory::createDirectory(folder_, false, true)) {
+			ofLogError("ofxSurfingSupabaseBackendLocal") << "connect(): ✗ Can't create " << folder_;
+			return false;
+		}
+	}
+
+	// Index every preset once, the payloads stay on disk
+	entries_.clear();
+	std::error_code ec;
+	for (auto & item : std::filesystem::directory_iterator(folder_, ec)) {
+		if (!item.is_regular_file() || item.path().extension() != FILE_EXTENSION) continue;
+
+		ofJson json;
+		if (!parseMapped(item.path().string(), json) || !json.contains("preset_name")) continue;
+
+		std::string name = json["preset_name"].get<std::string>();
+
+		// Written before uppercase was encoded: move it to its current file name
+		std::string path = getPath(name);
+		if (item.path().filename() != std::filesystem::path(path).filename()) {
+			std::error_code ecRename;
+			if (std::filesystem::exists(path, ecRename)) continue;
+			std::filesystem::rename(item.path(), path, ecRename);
+			if (ecRename) {
+				ofLogWarning("ofxSurfingSupabaseBackendLocal") << "connect(): Can't rename " << item.path().filename() << ", " << ecRename.message();
+				continue;
+			}
+		}
+
+		Entry entry;
+		entry.createdAt = json.value("created_at", "");
+		entry.updatedAt = json.value("updated_at", "");
+		entries_[name] = entry;
+	}
+
+	userId = "local";
+
+	ofLogNotice("ofxSurfingSupabaseBackendLocal") << "connect(): ✓ " << entries_.size() << " presets";
+	return true;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doLoad(const std::string & name, const std::string & updatedAfter, Row & row) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// Missing or not newer: an empty row, like an empty PostgREST array
+	Row found;
+	auto it = entries_.find(name);
+	if (it != entries_.end() && it->second.updatedAt > updatedAfter) {
+		if (!readPayload(name, found.payload)) {
+			return Result { 500, false, "Can't read " + getPath(name) };
+		}
+		found.name = name;
+		found.updatedAt = it->second.updatedAt;
+	}
+
+	row = std::move(found);
+	return Result { 200, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doSave(const Row & row, bool overwrite, Row & saved) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return saveLocked(row, overwrite, saved);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doRemove(const std::string & name) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return removeLocked(name);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doList(const Query & query, std::vector<Row> & rows, int & total) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	struct Match {
+		const std::string * name;
+		const Entry * entry;
+	};
+	std::vector<Match> matches;
+	matches.reserve(entries_.size());
+
+	for (auto & item : entries_) {
+		if (!query.updatedAfter.empty() && item.second.updatedAt <= query.updatedAfter) continue;
+		if (!query.namePrefix.empty() && item.first.compare(0, query.namePrefix.size(), query.namePrefix) != 0) continue;
+		matches.push_back({ &item.first, &item.second });
+	}
+
+	std::sort(matches.begin(), matches.end(), [&query](const Match & a, const Match & b) {
+		const std::string & ka = query.byUpdated ? a.entry->updatedAt : a.entry->createdAt;
+		const std::string & kb = query.byUpdated ? b.entry->updatedAt : b.entry->createdAt;
+		return ka != kb ? ka < kb : *a.name < *b.name;
+	});
+
+	if (query.count) total = static_cast<int>(matches.size());
+
+	std::size_t first = std::min(matches.size(), static_cast<std::size_t>(std::max(0, query.offset)));
+	std::size_t last = query.limit < 0 ? matches.size() : std::min(matches.size(), first + query.limit);
+
+	for (std::size_t i = first; i < last; ++i) {
+		Row row;
+		row.name = *matches[i].name;
+		row.updatedAt = matches[i].entry->updatedAt;
+		if (query.withData && !readPayload(row.name, row.payload)) {
+			return Result { 500, false, "Can't read " + getPath(row.name) };
+		}
+		rows.push_back(std::move(row));
+	}
+
+	return Result { 200, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doProbe(int & count, std::string & newest) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	count = static_cast<int>(entries_.size());
+	newest.clear();
+	for (auto & item : entries_) {
+		if (item.second.updatedAt > newest) newest = item.second.updatedAt;
+	}
+
+	return Result { 200, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doLoadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto & name : names) {
+		auto it = entries_.find(name);
+		if (it == entries_.end()) continue;
+
+		Row row;
+		row.name = name;
+		row.updatedAt = it->second.updatedAt;
+		if (!readPayload(name, row.payload)) {
+			return Result { 500, false, "Can't read " + getPath(name) };
+		}
+		rows.push_back(std::move(row));
+	}
+
+	return Result { 200, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doSaveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// All or nothing on conflicts, like a single PostgREST insert
+	if (!overwrite) {
+		for (auto & row : rows) {
+			if (entries_.count(row.name)) return Result { 409, false, "Duplicate preset_name: " + row.name };
+		}
+	}
+
+	for (auto & row : rows) {
+		Row rowSaved;
+		Result result = saveLocked(row, overwrite, rowSaved);
+		if (!result.success) return result;
+		saved.push_back(std::move(rowSaved));
+	}
+
+	return Result { 201, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doRemoveBulk(const std::vector<std::string> & names) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto & name : names) {
+		Result result = removeLocked(name);
+		if (!result.success) return result;
+	}
+
+	return Result { 204, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::doRemoveAll() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<std::string> names;
+	names.reserve(entries_.size());
+	for (auto & item : entries_) {
+		names.push_back(item.first);
+	}
+
+	for (auto & name : names) {
+		Result result = removeLocked(name);
+		if (!result.success) return result;
+	}
+
+	return Result { 204, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::saveLocked(const Row & row, bool overwrite, Row & saved) {
+	auto it = entries_.find(row.name);
+	if (it != entries_.end() && !overwrite) {
+		return Result { 409, false, "Duplicate preset_name: " + row.name };
+	}
+
+	ofJson json;
+	json["preset_name"] = row.name;
+	try {
+		json["preset_data"] = ofJson::parse(row.payload);
+	} catch (std::exception & e) {
+		return Result { 400, false, "Invalid JSON for " + row.name + ": " + e.what() };
+	}
+
+	Entry entry;
+	entry.updatedAt = makeTimestamp();
+	entry.createdAt = (it != entries_.end()) ? it->second.createdAt : entry.updatedAt;
+	json["created_at"] = entry.createdAt;
+	json["updated_at"] = entry.updatedAt;
+
+	if (!writeAtomic(getPath(row.name), json.dump())) {
+		return Result { 500, false, "Can't write " + getPath(row.name) };
+	}
+
+	entries_[row.name] = entry;
+
+	saved.name = row.name;
+	saved.updatedAt = entry.updatedAt;
+	saved.payload.clear();
+
+	return Result { 201, true, "" };
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendLocal::removeLocked(const std::string & name) {
+	// Deleting a missing preset succeeds, like a PostgREST DELETE matching no rows
+	std::error_code ec;
+	std::filesystem::remove(getPath(name), ec);
+	if (ec) {
+		return Result { 500, false, "Can't remove " + getPath(name) + ": " + ec.message() };
+	}
+
+	entries_.erase(name);
+	return Result { 204, true, "" };
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendLocal::readPayload(const std::string & name, std::string & payload) const {
+	ofJson json;
+	if (!parseMapped(getPath(name), json) || !json.contains("preset_data")) return false;
+
+	payload = json["preset_data"].dump();
+	return true;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendLocal::getPath(const std::string & name) const {
+	return ofFilePath::join(folder_, encodeFileName(name) + FILE_EXTENSION);
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendLocal::encodeFileName(const std::string & name) {
+	// Percent-encode anything a file system could choke on.
+	// Uppercase too: "Foo" and "foo" must not share a file where case is ignored.
+	static const char * hex = "0123456789ABCDEF";
+
+	std::string encoded;
+	encoded.reserve(name.size() * 3);
+
+	for (unsigned char c : name) {
+		if (std::islower(c) || std::isdigit(c) || c == '-' || c == '_' || c == ' ') {
+			encoded += static_cast<char>(c);
+		} else {
+			encoded += '%';
+			encoded += hex[c >> 4];
+			encoded += hex[c & 0x0F];
+		}
+	}
+
+	return encoded;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofxSurfingSupabaseBackend.h"
+
+#include <unordered_map>
+
+/*
+	Local directory backend: no network at all.
+
+	Each preset is one JSON file in the folder,
+	{ preset_name, created_at, updated_at, preset_data },
+	named after the percent-encoded preset name. Uppercase letters are
+	encoded too, so names differing only in case never share a file on
+	case insensitive file systems; connect() renames older files.
+	Files are read through a memory mapping and written via a temporary
+	file and a rename, so a crash never leaves a half written preset.
+	connect() scans the folder once, later listings come from memory.
+*/
+
+class ofxSurfingSupabaseBackendLocal : public ofxSurfingSupabaseBackend {
+public:
+	explicit ofxSurfingSupabaseBackendLocal(const std::string & folder);
+
+	std::string getName() const override { return "local"; }
+
+	// File name of a preset in the folder, without the extension
+	static std::string encodeFileName(const std::string & name);
+
+protected:
+	bool doConnect(std::string & userId) override;
+	Result doLoad(const std::string & name, const std::string & updatedAfter, Row & row) override;
+	Result doSave(const Row & row, bool overwrite, Row & saved) override;
+	Result doRemove(const std::string & name) override;
+	Result doList(const Query & query, std::vector<Row> & rows, int & total) override;
+	Result doProbe(int & count, std::string & newest) override;
+	Result doLoadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) override;
+	Result doSaveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) override;
+	Result doRemoveBulk(const std::vector<std::string> & names) override;
+	Result doRemoveAll() override;
+
+	// Disk errors do not heal by waiting: no retries, no breaker
+	bool isTransient(const Result &) const override { return false; }
+
+private:
+	struct Entry {
+		std::string createdAt;
+		std::string updatedAt;
+	};
+
+	// Callers hold mutex_
+	Result saveLocked(const Row & row, bool overwrite, Row & saved);
+	Result removeLocked(const std::string & name);
+	bool readPayload(const std::string & name, std::string & payload) const;
+
+	std::string getPath(const std::string & name) const;
+
+	std::mutex mutex_;
+	std::string folder_;
+	std::unordered_map<std::string, Entry> entries_;
+};
@@ -0,0 +1,1287 @@
+#include "ofxSurfingSupabaseBackendSupabase.h"
+
+#include "ofMain.h"
+
+#include <chrono>
+#include <cstdlib>
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "../libs/cpp-httplib/include/httplib.h"
+
+// Constants
+const std::string ofxSurfingSupabaseBackendSupabase::TABLE_NAME = "presets"; //TODO: to be used as kit name, alowing multiple kits
+const std::string ofxSurfingSupabaseBackendSupabase::PREFER_UPSERT_RETURN = "resolution=merge-duplicates,return=representation";
+const std::string ofxSurfingSupabaseBackendSupabase::PREFER_INSERT_RETURN = "return=representation";
+//TODO: add tag to be used as kit name filtering for multiple kits
+
+namespace {
+
+const std::string SELECT_ROW = "preset_name,updated_at";
+const std::string SELECT_ROW_DATA = "preset_name,updated_at,preset_data";
+
+int64_t getUnixTime() {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string base64UrlDecode(const std::string & in) {
+	std::string out;
+	int value = 0;
+	int bits = -8;
+	for (char c : in) {
+		int digit;
+		if (c >= 'A' && c <= 'Z') digit = c - 'A';
+		else if (c >= 'a' && c <= 'z') digit = c - 'a' + 26;
+		else if (c >= '0' && c <= '9') digit = c - '0' + 52;
+		else if (c == '-' || c == '+') digit = 62;
+		else if (c == '_' || c == '/') digit = 63;
+		else break; // Padding
+		value = (value << 6) | digit;
+		bits += 6;
+		if (bits >= 0) {
+			out += static_cast<char>((value >> bits) & 0xFF);
+			bits -= 8;
+		}
+	}
+	return out;
+}
+
+const double TIMING_ALPHA = 0.2; // EWMA weight of a new sample
+const double TIMEOUT_RTT_FACTOR = 4.0;
+const double TIMEOUT_TRANSFER_FACTOR = 3.0;
+
+double getEwma(double average, double sample) {
+	return average + TIMING_ALPHA * (sample - average);
+}
+
+void setTimeouts(httplib::SSLClient & client, int connectMs, int readMs, int writeMs) {
+	client.set_connection_timeout(std::chrono::milliseconds(connectMs));
+	client.set_read_timeout(std::chrono::milliseconds(readMs));
+	client.set_write_timeout(std::chrono::milliseconds(writeMs));
+}
+
+// Handshake start on this thread, handshakes run inside the blocking send
+thread_local const SSL * tlsHandshakeSsl = nullptr;
+thread_local std::chrono::steady_clock::time_point tlsHandshakeStart;
+
+// The hashed CA directory is read on demand, so its roots can't be counted up front
+bool hasDefaultCertDir() {
+	const char * dir = std::getenv(X509_get_default_cert_dir_env());
+	return ofDirectory::doesDirectoryExist(dir ? dir : X509_get_default_cert_dir(), false);
+}
+
+bool isTimeoutError(httplib::Error error) {
+	return error == httplib::Error::ConnectionTimeout || error == httplib::Error::Read || error == httplib::Error::Write;
+}
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+bool gzipCompress(const std::string & in, std::string & out) {
+	z_stream stream = {};
+	// 15 + 16: gzip wrapper, which servers expect for Content-Encoding: gzip
+	if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+	out.resize(deflateBound(&stream, static_cast<uLong>(in.size())));
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+	stream.avail_in = static_cast<uInt>(in.size());
+	stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+	stream.avail_out = static_cast<uInt>(out.size());
+
+	int ret = deflate(&stream, Z_FINISH);
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+	return ret == Z_STREAM_END;
+}
+
+bool gzipDecompress(const std::string & in, std::string & out) {
+	z_stream stream = {};
+	// 15 + 32: detect gzip or zlib wrapper
+	if (inflateInit2(&stream, 15 + 32) != Z_OK) return false;
+
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+	stream.avail_in = static_cast<uInt>(in.size());
+
+	out.clear();
+	char buffer[16384];
+	int ret;
+	do {
+		stream.next_out = reinterpret_cast<Bytef *>(buffer);
+		stream.avail_out = sizeof(buffer);
+		ret = inflate(&stream, Z_NO_FLUSH);
+		if (ret != Z_OK && ret != Z_STREAM_END) break;
+		out.append(buffer, sizeof(buffer) - stream.avail_out);
+	} while (ret != Z_STREAM_END);
+
+	inflateEnd(&stream);
+	return ret == Z_STREAM_END;
+}
+#endif
+
+bool parseRow(const ofJson & item, ofxSurfingSupabaseBackend::Row & row) {
+	if (!item.contains("preset_name")) return false;
+
+	row.name = item["preset_name"].get<std::string>();
+	// PostgREST returns timestamps in one fixed format, so they compare as strings
+	if (item.contains("updated_at") && item["updated_at"].is_string()) {
+		row.updatedAt = item["updated_at"].get<std::string>();
+	}
+	if (item.contains("preset_data")) {
+		row.payload = item["preset_data"].dump();
+	}
+	return true;
+}
+
+// Splits a JSON array of rows while it arrives: one row's text in memory at a time
+struct RowStream {
+	const std::function<void(ofxSurfingSupabaseBackend::Row &)> & onRow;
+	std::string object;
+	int depth = 0;
+	bool inString = false;
+	bool escape = false;
+	bool complete = false; // Closing bracket seen
+	bool failed = false;
+
+	bool feed(const char * data, std::size_t size) {
+		for (std::size_t i = 0; i < size && !failed; ++i) {
+			char c = data[i];
+
+			if (inString) {
+				object += c;
+				if (escape) escape = false;
+				else if (c == '\\') escape = true;
+				else if (c == '"') inString = false;
+			} else if (depth == 0) {
+				if (c == '[' && !complete) depth = 1;
+				else if (!std::isspace(static_cast<unsigned char>(c))) failed = true;
+			} else if (depth == 1) {
+				if (c == '{') {
+					object.assign(1, c);
+					depth = 2;
+				} else if (c == ']') {
+					depth = 0;
+					complete = true;
+				} else if (c != ',' && !std::isspace(static_cast<unsigned char>(c))) {
+					failed = true;
+				}
+			} else {
+				object += c;
+				if (c == '"') inString = true;
+				else if (c == '{' || c == '[') depth++;
+				else if ((c == '}' || c == ']') && --depth == 1) emit();
+			}
+		}
+		return !failed;
+	}
+
+	void emit() {
+		try {
+			ofxSurfingSupabaseBackend::Row row;
+			if (parseRow(ofJson::parse(object), row)) onRow(row);
+		} catch (std::exception & e) {
+			ofLogError("ofxSurfingSupabaseBackendSupabase") << "listEach(): " << e.what();
+			failed = true;
+		}
+		object.clear();
+	}
+};
+
+} // namespace
+
+struct ofxSurfingSupabaseBackendSupabase::RequestContext {
+	uint64_t revision = 0;
+	std::string userId;
+	httplib::Headers headers; // apikey and bearer token
+	httplib::Headers requestHeaders[HEADERS_NUM]; // Copied into each request, see HeaderSet
+
+	// Filtered by the session user
+	Endpoint load; // + name
+	Endpoint list; // + order and filters
+	Endpoint listData;
+	Endpoint probe;
+	Endpoint loadBulk; // + in list
+	Endpoint upsert;
+	Endpoint insert;
+	Endpoint remove; // + name
+	Endpoint removeBulk; // + in list
+	Endpoint removeAll;
+};
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::ofxSurfingSupabaseBackendSupabase(const Config & config)
+	: config_(config) {
+	// scheme://host[:port][/...]
+	std::string url = config_.supabaseUrl;
+	std::size_t schemeEnd = url.find("://");
+	scheme_ = schemeEnd == std::string::npos ? "https" : url.substr(0, schemeEnd);
+	std::string authority = schemeEnd == std::string::npos ? url : url.substr(schemeEnd + 3);
+	authority = authority.substr(0, authority.find('/'));
+
+	std::size_t colon = authority.rfind(':');
+	if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+		host_ = authority.substr(0, colon);
+		port_ = ofToInt(authority.substr(colon + 1));
+	} else {
+		host_ = authority;
+		port_ = scheme_ == "http" ? 80 : 443;
+	}
+
+	// The change probe polls anyway, the next poll is its retry
+	RetryPolicy probePolicy;
+	probePolicy.maxRetries = 0;
+	setRetryPolicy(OP_PROBE, probePolicy);
+
+	// Writes are journaled and replayed with their own backoff: retry once, fail fast
+	RetryPolicy writePolicy;
+	writePolicy.maxRetries = 1;
+	writePolicy.breakerThreshold = 3;
+	setRetryPolicy(OP_SAVE, writePolicy);
+	setRetryPolicy(OP_REMOVE, writePolicy);
+	setRetryPolicy(OP_SAVE_BULK, writePolicy);
+	setRetryPolicy(OP_REMOVE_BULK, writePolicy);
+
+	// Bursts of twice the rate, under the project rate limits
+	RateLimit reads { config_.readRate, config_.readRate * 2 };
+	RateLimit writes { config_.writeRate, config_.writeRate * 2 };
+	setRateLimits(reads, writes);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::~ofxSurfingSupabaseBackendSupabase() {
+	stopRefreshThread();
+
+	{
+		std::lock_guard<std::mutex> lock(clientPoolMutex_);
+		clientPool_.clear();
+	}
+	if (tlsSession_) SSL_SESSION_free(tlsSession_);
+	if (caStore_) X509_STORE_free(caStore_);
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::Config::isValid() const {
+	if (authMode == "ANON_KEY") {
+		return !supabaseUrl.empty() && !supabaseAnonKey.empty();
+	}
+
+	if (authMode == "EMAIL_PASSWORD") {
+		return !supabaseUrl.empty() && !supabaseAnonKey.empty() && !email.empty() && !password.empty();
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::doConnect(std::string & userId) {
+	ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "authenticate()";
+
+	stopRefreshThread();
+
+	if (scheme_ != "https") {
+		ofLogWarning("ofxSurfingSupabaseBackendSupabase") << "Only https is supported, connecting to " << host_ << ":" << port_ << " over TLS";
+	}
+
+	// Check auth mode
+	if (config_.authMode == "ANON_KEY") {
+		// Simple mode: just use anon key, no email/password
+		ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "Using ANON_KEY authentication (no user login)";
+
+		// Use anon key as auth token, long lived: nothing to renew
+		userId = "anonymous"; // No real user ID
+		setSession(config_.supabaseAnonKey, "", 0, userId);
+
+		ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "✓ Connected with ANON_KEY";
+		return true;
+	} else if (config_.authMode == "EMAIL_PASSWORD") {
+		// Full auth mode: login with email/password
+		ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "Using EMAIL_PASSWORD authentication";
+
+		// Build auth request
+		ofJson authData;
+		authData["email"] = config_.email;
+		authData["password"] = config_.password;
+
+		int status = 0;
+		if (requestToken("password", authData.dump(), userId, status)) {
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "✓ Authenticated successfully";
+			if (bDebug_) {
+				ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "User ID: " << userId;
+			}
+
+			startRefreshThread();
+			return true;
+		}
+	} else {
+		ofLogError("ofxSurfingSupabaseBackendSupabase") << "Unknown AUTH_MODE: " << config_.authMode;
+		ofLogError("ofxSurfingSupabaseBackendSupabase") << "Supported modes: ANON_KEY, EMAIL_PASSWORD";
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::requestToken(const std::string & grantType, const std::string & body, std::string & userId, int & status) {
+	status = 0;
+
+	try {
+		static const std::string timingKey = "POST /auth/v1/token";
+		std::string endpoint = "/auth/v1/token?grant_type=" + grantType;
+		Timeouts timeouts = getTimeouts(timingKey, body.size());
+
+		// Not pooled: pooled clients carry the bearer header of the old session
+		auto client = createClient();
+		setTimeouts(*client, timeouts.connectMs, timeouts.readMs, timeouts.writeMs);
+
+		// Set headers
+		httplib::Headers headers = {
+			{ "Content-Type", "application/json" },
+			{ "apikey", config_.supabaseAnonKey }
+		};
+
+		// Perform authentication
+		auto timeStart = std::chrono::steady_clock::now();
+		auto res = client->Post(endpoint.c_str(), headers, body, "application/json");
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count();
+		addTimingSample(timingKey, body.size(), res ? res->body.size() : 0, elapsedMs, !res && isTimeoutError(res.error()));
+
+		if (res && res->status == 200) {
+			status = res->status;
+			try {
+				ofJson responseJson = ofJson::parse(res->body);
+				userId = responseJson["user"]["id"].get<std::string>();
+				setSession(responseJson["access_token"].get<std::string>(),
+					responseJson.value("refresh_token", ""),
+					responseJson.value("expires_in", int64_t(0)),
+					userId);
+				return true;
+			} catch (std::exception & e) {
+				ofLogError("ofxSurfingSupabaseBackendSupabase") << "Failed to parse auth response: " << e.what();
+			}
+		} else {
+			status = res ? res->status : 0;
+			std::string errorMsg = res ? res->body : "Connection failed";
+			ofLogError("ofxSurfingSupabaseBackendSupabase") << "✗ Authentication failed (" << grantType << "): HTTP " << status;
+			if (!res) {
+				ofLogError("ofxSurfingSupabaseBackendSupabase") << "Error: " << httplib::to_string(res.error());
+			}
+			if (bDebug_) {
+				ofLogError("ofxSurfingSupabaseBackendSupabase") << errorMsg;
+			}
+		}
+	} catch (std::exception & e) {
+		ofLogError("ofxSurfingSupabaseBackendSupabase") << "Exception during authentication: " << e.what();
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::setSession(const std::string & accessToken, const std::string & refreshToken, int64_t expiresIn, const std::string & userId) {
+	int64_t issuedAt = 0;
+	int64_t expiresAt = 0;
+
+	// Trust the exp claim, the response's expires_in is the fallback
+	if (!parseTokenTimes(accessToken, issuedAt, expiresAt) && expiresIn > 0) {
+		issuedAt = getUnixTime();
+		expiresAt = issuedAt + expiresIn;
+	}
+
+	// Everything a request needs that only changes with the session
+	auto context = std::make_shared<RequestContext>();
+	context->userId = userId;
+	context->headers = {
+		{ "apikey", config_.supabaseAnonKey },
+		{ "Authorization", "Bearer " + accessToken }
+	};
+
+	std::string path = "/rest/v1/" + TABLE_NAME;
+	std::string table = path + "?user_id=eq." + urlEncode(userId);
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+	for (auto & headers : context->requestHeaders) {
+		headers.emplace("Accept-Encoding", "gzip");
+	}
+#endif
+	context->requestHeaders[HEADERS_COUNT].emplace("Prefer", "count=exact");
+	context->requestHeaders[HEADERS_UPSERT].emplace("Content-Type", "application/json");
+	context->requestHeaders[HEADERS_UPSERT].emplace("Prefer", PREFER_UPSERT_RETURN);
+	context->requestHeaders[HEADERS_INSERT].emplace("Content-Type", "application/json");
+	context->requestHeaders[HEADERS_INSERT].emplace("Prefer", PREFER_INSERT_RETURN);
+
+	auto makeEndpoint = [](const std::string & method, const std::string & endpointPath, const std::string & timingName, HeaderSet headers = HEADERS_READ) {
+		// Timing keys tell rows with and without payloads apart
+		return Endpoint { method, endpointPath, method + " " + timingName, headers };
+	};
+	context->load = makeEndpoint("GET", table + "&select=" + SELECT_ROW_DATA + "&preset_name=eq.", "load");
+	context->list = makeEndpoint("GET", table + "&select=" + SELECT_ROW, "list");
+	context->listData = makeEndpoint("GET", table + "&select=" + SELECT_ROW_DATA, "list data");
+	context->probe = makeEndpoint("GET", table + "&select=updated_at&order=updated_at.desc&limit=1", "probe", HEADERS_COUNT);
+	context->loadBulk = makeEndpoint("GET", table + "&select=" + SELECT_ROW_DATA + "&preset_name=in.", "load bulk");
+	context->upsert = makeEndpoint("POST", path + "?on_conflict=user_id,preset_name&select=" + SELECT_ROW, "upsert", HEADERS_UPSERT);
+	context->insert = makeEndpoint("POST", path + "?select=" + SELECT_ROW, "insert", HEADERS_INSERT);
+	context->remove = makeEndpoint("DELETE", table + "&preset_name=eq.", "remove");
+	context->removeBulk = makeEndpoint("DELETE", table + "&preset_name=in.", "remove bulk");
+	context->removeAll = makeEndpoint("DELETE", table, "remove all");
+
+	std::lock_guard<std::mutex> lock(authMutex_);
+	context->revision = ++contextRevision_;
+	context_ = context;
+	authToken_ = accessToken;
+	refreshToken_ = refreshToken;
+	tokenIssuedAt_ = issuedAt;
+	tokenExpiresAt_ = expiresAt;
+}
+
+//--------------------------------------------------------------
+int64_t ofxSurfingSupabaseBackendSupabase::getRenewTime() const {
+	std::lock_guard<std::mutex> lock(authMutex_);
+	if (refreshToken_.empty() || tokenExpiresAt_ == 0) return 0;
+
+	// At 80% of the lifetime, and never later than the margin before expiry
+	int64_t lifetime = std::max<int64_t>(0, tokenExpiresAt_ - tokenIssuedAt_);
+	int64_t margin = std::max<int64_t>(REFRESH_MARGIN_S, lifetime / 5);
+	return tokenExpiresAt_ - margin;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::refreshSession(const std::string & staleToken) {
+	// Proactive and reactive renewals share this: whoever comes second finds a fresh token
+	std::lock_guard<std::mutex> lockCall(refreshCallMutex_);
+
+	std::string refreshToken;
+	{
+		std::lock_guard<std::mutex> lock(authMutex_);
+		if (authToken_ != staleToken) return true;
+		refreshToken = refreshToken_;
+	}
+	if (refreshToken.empty()) return false; // ANON_KEY: nothing to renew
+
+	ofJson body;
+	body["refresh_token"] = refreshToken;
+
+	std::string userId;
+	int status = 0;
+	if (requestToken("refresh_token", body.dump(), userId, status)) {
+		if (bDebug_) {
+			int64_t expiresAt;
+			{
+				std::lock_guard<std::mutex> lock(authMutex_);
+				expiresAt = tokenExpiresAt_;
+			}
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "refreshSession(): ✓ Session renewed, expires in " << (expiresAt - getUnixTime()) << " s";
+		}
+		return true;
+	}
+
+	// Refresh token revoked or already used: log in again
+	if (status == 400 || status == 401) {
+		ofLogWarning("ofxSurfingSupabaseBackendSupabase") << "refreshSession(): Refresh token rejected, logging in again";
+
+		ofJson authData;
+		authData["email"] = config_.email;
+		authData["password"] = config_.password;
+		return requestToken("password", authData.dump(), userId, status);
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::startRefreshThread() {
+	if (getRenewTime() == 0) return;
+
+	refreshThreadRunning_ = true;
+	refreshThread_ = std::thread(&ofxSurfingSupabaseBackendSupabase::refreshThreadFunction, this);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::stopRefreshThread() {
+	if (!refreshThread_.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(refreshMutex_);
+		refreshThreadRunning_ = false;
+	}
+	refreshCondition_.notify_one();
+	refreshThread_.join();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::refreshThreadFunction() {
+	int64_t retrySeconds = 0;
+
+	while (refreshThreadRunning_) {
+		int64_t renewAt = getRenewTime();
+		if (renewAt == 0) break;
+
+		int64_t waitSeconds = retrySeconds > 0 ? retrySeconds : std::max<int64_t>(0, renewAt - getUnixTime());
+		{
+			std::unique_lock<std::mutex> lock(refreshMutex_);
+			refreshCondition_.wait_for(lock, std::chrono::seconds(waitSeconds), [this]() { return !refreshThreadRunning_; });
+		}
+		if (!refreshThreadRunning_) break;
+
+		// A reactive renewal may have moved the deadline meanwhile
+		if (retrySeconds == 0 && getUnixTime() < getRenewTime()) continue;
+
+		if (refreshSession(getAuthToken())) {
+			retrySeconds = 0;
+		} else {
+			retrySeconds = std::min<int64_t>(std::max<int64_t>(REFRESH_RETRY_MIN_S, retrySeconds * 2), REFRESH_RETRY_MAX_S);
+			ofLogWarning("ofxSurfingSupabaseBackendSupabase") << "refreshSession(): ✗ Renewal failed, retry in " << retrySeconds << " s";
+		}
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::parseTokenTimes(const std::string & token, int64_t & issuedAt, int64_t & expiresAt) {
+	// header.payload.signature, the payload is base64url JSON with iat and exp claims
+	std::size_t first = token.find('.');
+	std::size_t second = token.find('.', first + 1);
+	if (first == std::string::npos || second == std::string::npos) return false;
+
+	try {
+		ofJson claims = ofJson::parse(base64UrlDecode(token.substr(first + 1, second - first - 1)));
+		expiresAt = claims.value("exp", int64_t(0));
+		issuedAt = claims.value("iat", int64_t(0));
+		if (issuedAt == 0) issuedAt = getUnixTime();
+		return expiresAt > 0;
+	} catch (std::exception &) {
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doLoad(const std::string & name, const std::string & updatedAfter, Row & row) {
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	std::string suffix = urlEncode(name);
+	if (!updatedAfter.empty()) {
+		// Empty response when the caller's copy is still current
+		suffix += "&updated_at=gt." + urlEncode(updatedAfter);
+	}
+
+	HttpResponse res = httpGet(context->load, suffix);
+	Result result = makeResult(res);
+
+	std::vector<Row> rows;
+	if (result.success && !parseRows(res.body, rows)) {
+		result.success = false;
+		result.error = "Invalid response";
+	}
+	row = rows.empty() ? Row() : rows.front();
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doSave(const Row & row, bool overwrite, Row & saved) {
+	std::vector<Row> rows { row };
+	std::vector<Row> savedRows;
+
+	Result result = doSaveBulk(rows, overwrite, savedRows);
+
+	// Accepted without a representation (stripped by a proxy): read the server stamp back.
+	// Should that fail too, the empty stamp tells the caller it is unknown.
+	if (result.success && savedRows.empty()) {
+		Row loaded;
+		Result reload = doLoad(row.name, "", loaded);
+		result.requests += reload.requests;
+		result.bytesSent += reload.bytesSent;
+		result.bytesReceived += reload.bytesReceived;
+		savedRows.push_back(Row { row.name, reload.success ? loaded.updatedAt : "", "" });
+	}
+
+	saved = savedRows.front();
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doRemove(const std::string & name) {
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	return makeResult(httpDelete(context->remove, urlEncode(name)));
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doList(const Query & query, std::vector<Row> & rows, int & total) {
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	std::string range;
+	std::string suffix = makeListSuffix(query, range);
+
+	HttpResponse res = httpGet(query.withData ? context->listData : context->list, suffix, query.count ? "count=exact" : "", range);
+	Result result = makeResult(res);
+
+	if (result.success) {
+		total = parseContentRangeTotal(res.contentRange);
+		if (!parseRows(res.body, rows)) {
+			result.success = false;
+			result.error = "Invalid response";
+		}
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doListEach(const Query & query, const std::function<void(Row &)> & onRow, int & total) {
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	std::string range;
+	std::string suffix = makeListSuffix(query, range);
+
+	// Rows are parsed and handed over while the page is still arriving
+	RowStream stream { onRow };
+	HttpResponse res = httpRequest(query.withData ? context->listData : context->list, suffix, "", query.count ? "count=exact" : "", range,
+		[&](const char * data, std::size_t size) { return stream.feed(data, size); });
+	Result result = makeResult(res);
+
+	// Answered but unreadable: not worth a retry, like doList()
+	if (stream.failed || (result.success && !stream.complete)) {
+		result.status = 200;
+		result.success = false;
+		result.error = "Invalid response";
+	} else if (result.success) {
+		total = parseContentRangeTotal(res.contentRange);
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendSupabase::makeListSuffix(const Query & query, std::string & range) {
+	//// Sort descendent
+	//std::string suffix = "&order=created_at.desc";
+	// Sort ascendent
+	std::string suffix = query.byUpdated ? "&order=updated_at.asc" : "&order=created_at.asc";
+
+	if (!query.updatedAfter.empty()) {
+		suffix += "&updated_at=gt." + urlEncode(query.updatedAfter);
+	}
+	if (!query.namePrefix.empty()) {
+		suffix += "&preset_name=like." + urlEncode(query.namePrefix) + "*";
+	}
+
+	if (query.limit > 0) {
+		range = ofToString(query.offset) + "-" + ofToString(query.offset + query.limit - 1);
+	} else if (query.offset > 0) {
+		range = ofToString(query.offset) + "-";
+	}
+
+	return suffix;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doProbe(int & count, std::string & newest) {
+	// Newest updated_at plus the exact row count (from Content-Range), in a single row response
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	HttpResponse res = httpGet(context->probe, "");
+	Result result = makeResult(res);
+	if (!result.success) return result;
+
+	count = parseContentRangeTotal(res.contentRange);
+	if (count < 0) {
+		result.success = false;
+		result.error = "Row count unavailable";
+		return result;
+	}
+
+	std::vector<Row> rows;
+	if (!parseRows(res.body, rows)) {
+		result.success = false;
+		result.error = "Invalid response";
+		return result;
+	}
+	newest = rows.empty() ? "" : rows.front().updatedAt;
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doLoadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) {
+	if (names.empty()) return Result { 200, true, "" };
+
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	HttpResponse res = httpGet(context->loadBulk, makeInList(names));
+	Result result = makeResult(res);
+
+	if (result.success && !parseRows(res.body, rows)) {
+		result.success = false;
+		result.error = "Invalid response";
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doSaveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) {
+	if (rows.empty()) return Result { 200, true, "" };
+
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	// updated_at is left to the server: the touch trigger stamps every insert and upsert,
+	// so only server clocks are ever compared (docs/SUPABASE-SETUP.md, step 4)
+	// One array body, one round trip
+	ofJson insertData = ofJson::array();
+	for (auto & row : rows) {
+		ofJson item;
+		item["user_id"] = context->userId;
+		item["preset_name"] = row.name;
+		try {
+			item["preset_data"] = ofJson::parse(row.payload);
+		} catch (std::exception & e) {
+			return Result { 400, false, "Invalid JSON for " + row.name + ": " + e.what() };
+		}
+		insertData.push_back(std::move(item));
+	}
+
+	// Upsert on the unique (user_id, preset_name) pair, or a plain insert failing with 409.
+	// Ask for the rows back so callers learn updated_at without a second GET.
+	const Endpoint & endpoint = overwrite ? context->upsert : context->insert;
+
+	if (bDebug_) {
+		ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "doSaveBulk(): Saving " << rows.size() << " rows to: " << endpoint.path;
+	}
+
+	HttpResponse res = httpPost(endpoint, insertData.dump());
+	Result result = makeResult(res);
+
+	if (result.success && !parseRows(res.body, saved)) {
+		ofLogWarning("ofxSurfingSupabaseBackendSupabase") << "doSaveBulk(): Failed to parse save response";
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doRemoveBulk(const std::vector<std::string> & names) {
+	if (names.empty()) return Result { 200, true, "" };
+
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	return makeResult(httpDelete(context->removeBulk, makeInList(names)));
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::doRemoveAll() {
+	auto context = getContext();
+	if (!context) return Result { 0, false, "Not connected" };
+
+	return makeResult(httpDelete(context->removeAll, ""));
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::HttpResponse ofxSurfingSupabaseBackendSupabase::httpGet(const Endpoint & endpoint, const std::string & suffix, const std::string & prefer, const std::string & range) {
+	return httpRequest(endpoint, suffix, "", prefer, range);
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::HttpResponse ofxSurfingSupabaseBackendSupabase::httpPost(const Endpoint & endpoint, const std::string & jsonBody) {
+	return httpRequest(endpoint, "", jsonBody, "", "");
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::HttpResponse ofxSurfingSupabaseBackendSupabase::httpDelete(const Endpoint & endpoint, const std::string & suffix) {
+	return httpRequest(endpoint, suffix, "", "", "");
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::HttpResponse ofxSurfingSupabaseBackendSupabase::httpRequest(const Endpoint & endpoint, const std::string & suffix, const std::string & body, const std::string & prefer, const std::string & range, const BodyReceiver & receiver) {
+	auto context = getContext();
+	if (!context) return HttpResponse();
+
+	std::string token = getAuthToken();
+	HttpResponse result = httpSend(*context, endpoint, suffix, body, prefer, range, receiver);
+
+	// Expired despite the proactive renewal (suspended machine, clock skew): renew once and retry
+	if (result.statusCode == 401 && refreshSession(token)) {
+		ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "HTTP " << endpoint.method << ": Token renewed after 401, retrying";
+		HttpResponse first = std::move(result);
+		result = httpSend(*getContext(), endpoint, suffix, body, prefer, range, receiver);
+		result.requests += first.requests;
+		result.bytesSent += first.bytesSent;
+		result.bytesReceived += first.bytesReceived;
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::HttpResponse ofxSurfingSupabaseBackendSupabase::httpSend(const RequestContext & context, const Endpoint & endpoint, const std::string & suffix, const std::string & body, const std::string & prefer, const std::string & range, const BodyReceiver & receiver) {
+	HttpResponse result;
+	result.success = false;
+
+	const std::string & method = endpoint.method;
+
+	try {
+		if (bDebug_) {
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "HTTP " << method << ": " << endpoint.path << suffix;
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "Host: " << host_;
+		}
+
+		const std::string & timingKey = endpoint.timingKey;
+		Timeouts timeouts = getTimeouts(timingKey, body.size());
+
+		if (bDebug_) {
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "Timeouts: connect " << timeouts.connectMs << " ms, read " << timeouts.readMs << " ms, write " << timeouts.writeMs << " ms";
+		}
+
+		PooledClient pooled = acquireClient(context);
+		httplib::SSLClient & client = *pooled.client;
+		setTimeouts(client, timeouts.connectMs, timeouts.readMs, timeouts.writeMs);
+
+		// Auth headers are the client's defaults, the endpoint's fixed ones are prebuilt,
+		// only those that vary per call are added here
+		httplib::Request req;
+		req.method = method;
+		req.path = endpoint.path + suffix;
+		req.headers = context.requestHeaders[endpoint.headers];
+		req.body = body;
+
+		// Streamed: a 2xx body goes to the receiver as it arrives, an error body is kept
+		int streamedStatus = 0;
+		std::size_t streamedBytes = 0;
+		std::string errorBody;
+		if (receiver) {
+			req.response_handler = [&](const httplib::Response & response) {
+				streamedStatus = response.status;
+				return true;
+			};
+			req.content_receiver = [&](const char * data, std::size_t size, std::size_t, std::size_t) {
+				streamedBytes += size;
+				if (streamedStatus < 200 || streamedStatus >= 300) {
+					errorBody.append(data, size);
+					return true;
+				}
+				return receiver(data, size);
+			};
+		}
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+		// Inflated here rather than by httplib, to time it.
+		// A streamed body can't wait for the whole response: httplib inflates it on the fly.
+		client.set_decompress(static_cast<bool>(receiver));
+
+		if (config_.compressThreshold > 0 && body.size() >= static_cast<std::size_t>(config_.compressThreshold)) {
+			auto codecStart = std::chrono::steady_clock::now();
+			std::string compressed;
+			if (gzipCompress(body, compressed) && compressed.size() < body.size()) {
+				compressionStats_.sentRaw += body.size();
+				compressionStats_.sentWire += compressed.size();
+				req.headers.emplace("Content-Encoding", "gzip");
+				req.body = std::move(compressed);
+			}
+			compressionStats_.micros += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - codecStart).count();
+		}
+#endif
+		if (!prefer.empty()) {
+			req.headers.emplace("Prefer", prefer);
+		}
+		if (!range.empty()) {
+			req.headers.emplace("Range-Unit", "items");
+			req.headers.emplace("Range", range);
+		}
+
+		auto timeStart = std::chrono::steady_clock::now();
+		auto res = client.send(req);
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count();
+		// A streamed read also waits on its consumer, that time is not the link's
+		if (!receiver) {
+			addTimingSample(timingKey, req.body.size(), res ? res->body.size() : 0, elapsedMs, !res && isTimeoutError(res.error()));
+		}
+		releaseClient(std::move(pooled));
+		tlsStats_.requests++;
+		result.requests = 1;
+		result.bytesSent = req.path.size() + req.body.size();
+
+		if (res) {
+			result.bytesReceived = receiver ? streamedBytes : res->body.size();
+			result.statusCode = res->status;
+			result.body = receiver ? std::move(errorBody) : std::move(res->body);
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+			if (!receiver && res->get_header_value("Content-Encoding") == "gzip") {
+				auto codecStart = std::chrono::steady_clock::now();
+				std::string inflated;
+				if (gzipDecompress(result.body, inflated)) {
+					compressionStats_.receivedRaw += inflated.size();
+					compressionStats_.receivedWire += result.body.size();
+					result.body = std::move(inflated);
+				} else {
+					ofLogError("ofxSurfingSupabaseBackendSupabase") << "HTTP " << method << ": Invalid gzip response";
+					result.statusCode = 0;
+				}
+				compressionStats_.micros += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - codecStart).count();
+			}
+#endif
+
+			result.contentRange = res->get_header_value("Content-Range");
+			result.retryAfterMs = parseRetryAfter(res->get_header_value("Retry-After"));
+			result.success = (result.statusCode >= 200 && result.statusCode < 300);
+
+			if (bDebug_) {
+				ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "Response: HTTP " << result.statusCode;
+			}
+		} else {
+			auto err = res.error();
+			ofLogError("ofxSurfingSupabaseBackendSupabase") << "HTTP " << method << " failed - Error: " << httplib::to_string(err);
+			result.statusCode = 0;
+			result.body = "Connection error: " + std::string(httplib::to_string(err));
+		}
+	} catch (std::exception & e) {
+		ofLogError("ofxSurfingSupabaseBackendSupabase") << "HTTP " << method << " exception: " << e.what();
+	}
+
+	return result;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::Timeouts ofxSurfingSupabaseBackendSupabase::getTimeouts(const std::string & key, std::size_t requestBytes) const {
+	Timeouts timeouts = { TIMEOUT_DEFAULT_MS, TIMEOUT_DEFAULT_MS, TIMEOUT_DEFAULT_MS };
+
+	std::lock_guard<std::mutex> lock(linkMutex_);
+	auto it = links_.find(key);
+	if (it == links_.end()) return timeouts;
+	const Link & link = it->second;
+
+	double latency = link.rttMs > 0 ? link.rttMs : linkRttMs_;
+	if (latency <= 0) return timeouts;
+
+	// Unmeasured throughput: small transfers cost nothing extra, large ones get the ceiling
+	auto getTransferMs = [&](double bytes) -> double {
+		if (link.bytesPerMs > 0) return bytes / link.bytesPerMs;
+		return bytes < TIMING_SMALL_BYTES ? 0 : TIMEOUT_CEILING_MS;
+	};
+
+	double connect = TIMEOUT_RTT_FACTOR * latency;
+	double read = TIMEOUT_RTT_FACTOR * latency + TIMEOUT_TRANSFER_FACTOR * getTransferMs(link.responseBytes);
+	double write = TIMEOUT_RTT_FACTOR * latency + TIMEOUT_TRANSFER_FACTOR * getTransferMs(static_cast<double>(requestBytes));
+
+	timeouts.connectMs = static_cast<int>(std::max<double>(TIMEOUT_CONNECT_FLOOR_MS, std::min<double>(connect, TIMEOUT_DEFAULT_MS)));
+	timeouts.readMs = static_cast<int>(std::max<double>(TIMEOUT_FLOOR_MS, std::min<double>(read, TIMEOUT_CEILING_MS)));
+	timeouts.writeMs = static_cast<int>(std::max<double>(TIMEOUT_FLOOR_MS, std::min<double>(write, TIMEOUT_CEILING_MS)));
+	return timeouts;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::addTimingSample(const std::string & key, std::size_t requestBytes, std::size_t responseBytes, double elapsedMs, bool timedOut) {
+	std::lock_guard<std::mutex> lock(linkMutex_);
+	Link & link = links_[key];
+
+	// Too tight for the current link: back off like a TCP retransmit timer
+	if (timedOut) {
+		if (link.rttMs > 0) link.rttMs = std::min(link.rttMs * 2, static_cast<double>(TIMEOUT_DEFAULT_MS));
+		return;
+	}
+
+	std::size_t bytes = requestBytes + responseBytes;
+	if (bytes < TIMING_SMALL_BYTES) {
+		link.rttMs = link.rttMs > 0 ? getEwma(link.rttMs, elapsedMs) : elapsedMs;
+		linkRttMs_ = linkRttMs_ > 0 ? getEwma(linkRttMs_, elapsedMs) : elapsedMs;
+	} else if (linkRttMs_ > 0 && elapsedMs > linkRttMs_ + 1) {
+		double bytesPerMs = bytes / (elapsedMs - linkRttMs_);
+		link.bytesPerMs = link.bytesPerMs > 0 ? getEwma(link.bytesPerMs, bytesPerMs) : bytesPerMs;
+	}
+
+	link.responseBytes = link.samples > 0 ? getEwma(link.responseBytes, static_cast<double>(responseBytes)) : responseBytes;
+	link.samples++;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::CompressionStats ofxSurfingSupabaseBackendSupabase::getCompressionStats() const {
+	CompressionStats stats;
+	stats.sentRaw = compressionStats_.sentRaw;
+	stats.sentWire = compressionStats_.sentWire;
+	stats.receivedRaw = compressionStats_.receivedRaw;
+	stats.receivedWire = compressionStats_.receivedWire;
+	stats.micros = compressionStats_.micros;
+	return stats;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackendSupabase::PooledClient ofxSurfingSupabaseBackendSupabase::acquireClient(const RequestContext & context) {
+	PooledClient pooled;
+	{
+		std::lock_guard<std::mutex> lock(clientPoolMutex_);
+		if (!clientPool_.empty()) {
+			pooled = std::move(clientPool_.back());
+			clientPool_.pop_back();
+		}
+	}
+	if (!pooled.client) pooled.client = createClient();
+
+	// Only after a token change
+	if (pooled.revision != context.revision) {
+		pooled.client->set_default_headers(context.headers);
+		pooled.revision = context.revision;
+	}
+
+	return pooled;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::releaseClient(PooledClient client) {
+	std::lock_guard<std::mutex> lock(clientPoolMutex_);
+	if (static_cast<int>(clientPool_.size()) < CLIENT_POOL_MAX) {
+		clientPool_.push_back(std::move(client));
+	}
+}
+
+//--------------------------------------------------------------
+std::unique_ptr<httplib::SSLClient> ofxSurfingSupabaseBackendSupabase::createClient() {
+	auto client = std::make_unique<httplib::SSLClient>(host_, port_);
+	client->set_keep_alive(true);
+
+	// OpenSSL checks chain and host name itself while handshaking,
+	// so httplib's own check (which loads certificates per client) stays off
+	client->enable_server_certificate_verification(false);
+
+	SSL_CTX * ctx = client->ssl_context();
+	if (!ctx) return client;
+
+	if (config_.verifyTls) {
+		X509_STORE * store = getCaStore();
+		if (store) {
+			X509_STORE_up_ref(store); // The context frees its reference
+			SSL_CTX_set_cert_store(ctx, store);
+		}
+		SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+		X509_VERIFY_PARAM_set1_host(SSL_CTX_get0_param(ctx), host_.c_str(), 0);
+	}
+
+	// Session tickets: kept by us, offered again on the next handshake (see onTlsInfo).
+	// Pooled keep-alive clients skip most handshakes, resumption shortens the rest.
+	SSL_CTX_set_app_data(ctx, this);
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(ctx, onTlsNewSession);
+	SSL_CTX_set_info_callback(ctx, onTlsInfo);
+
+	return client;
+}
+
+//--------------------------------------------------------------
+X509_STORE * ofxSurfingSupabaseBackendSupabase::getCaStore() {
+	std::call_once(caStoreOnce_, [this]() {
+		auto timeStart = std::chrono::steady_clock::now();
+		X509_STORE * store = X509_STORE_new();
+		if (!store) return;
+
+		bool loaded;
+		if (!config_.caBundle.empty()) {
+			std::string path = ofToDataPath(config_.caBundle, true);
+			loaded = X509_STORE_load_locations(store, path.c_str(), nullptr) == 1;
+			if (!loaded) ofLogError("ofxSurfingSupabaseBackendSupabase") << "✗ Failed to load CA bundle: " << path;
+		} else {
+			loaded = false;
+#ifdef _WIN32
+			loaded = httplib::detail::load_system_certs_on_windows(store);
+#elif defined(CPPHTTPLIB_USE_CERTS_FROM_MACOSX_KEYCHAIN) && TARGET_OS_MAC
+			loaded = httplib::detail::load_system_certs_on_macos(store);
+#endif
+#ifdef __APPLE__
+			// Without the keychain, OpenSSL's default paths are mostly empty on macOS;
+			// the system ships its roots as a PEM bundle too
+			if (!loaded) loaded = X509_STORE_load_locations(store, "/etc/ssl/cert.pem", nullptr) == 1;
+#endif
+			if (!loaded) {
+				// Succeeds even when the default file is missing: only the hashed dir can still hold roots
+				X509_STORE_set_default_paths(store);
+				loaded = sk_X509_OBJECT_num(X509_STORE_get0_objects(store)) > 0 || hasDefaultCertDir();
+			}
+			if (!loaded && config_.verifyTls) {
+				ofLogError("ofxSurfingSupabaseBackendSupabase") << "✗ No CA certificates found, set CA_BUNDLE to a PEM file";
+			}
+		}
+
+		if (bDebug_) {
+			double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count();
+			ofLogNotice("ofxSurfingSupabaseBackendSupabase") << "getCaStore(): " << (loaded ? "✓" : "✗") << " CA store loaded in " << ofToString(elapsedMs, 1) << " ms";
+		}
+		caStore_ = store;
+	});
+
+	return caStore_;
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackendSupabase::onTlsNewSession(SSL * ssl, SSL_SESSION * session) {
+	auto self = static_cast<ofxSurfingSupabaseBackendSupabase *>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+	if (!self) return 0;
+
+	std::lock_guard<std::mutex> lock(self->tlsSessionMutex_);
+	if (self->tlsSession_) SSL_SESSION_free(self->tlsSession_);
+	self->tlsSession_ = session;
+	return 1; // We own the reference now
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseBackendSupabase::onTlsInfo(const SSL * ssl, int where, int) {
+	auto self = static_cast<ofxSurfingSupabaseBackendSupabase *>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+	if (!self) return;
+
+	if (where & SSL_CB_HANDSHAKE_START) {
+		// Called inside SSL_connect before the ClientHello is built: the latest ticket
+		// offered here is resumed. A fresh SSL has no session yet, a renegotiation keeps its own.
+		if (!SSL_get_session(ssl)) {
+			std::lock_guard<std::mutex> lock(self->tlsSessionMutex_);
+			if (self->tlsSession_) SSL_set_session(const_cast<SSL *>(ssl), self->tlsSession_);
+		}
+		tlsHandshakeSsl = ssl;
+		tlsHandshakeStart = std::chrono::steady_clock::now();
+	} else if ((where & SSL_CB_HANDSHAKE_DONE) && tlsHandshakeSsl == ssl) {
+		tlsHandshakeSsl = nullptr;
+		auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tlsHandshakeStart).count();
+		if (SSL_session_reused(ssl)) {
+			self->tlsStats_.resumedHandshakes++;
+			self->tlsStats_.resumedMicros += micros;
+		} else {
+			self->tlsStats_.fullHandshakes++;
+			self->tlsStats_.fullMicros += micros;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::TlsStats ofxSurfingSupabaseBackendSupabase::getTlsStats() const {
+	TlsStats stats;
+	stats.requests = tlsStats_.requests;
+	stats.fullHandshakes = tlsStats_.fullHandshakes;
+	stats.resumedHandshakes = tlsStats_.resumedHandshakes;
+	stats.fullMicros = tlsStats_.fullMicros;
+	stats.resumedMicros = tlsStats_.resumedMicros;
+	return stats;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<const ofxSurfingSupabaseBackendSupabase::RequestContext> ofxSurfingSupabaseBackendSupabase::getContext() const {
+	std::lock_guard<std::mutex> lock(authMutex_);
+	return context_;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendSupabase::getAuthToken() const {
+	std::lock_guard<std::mutex> lock(authMutex_);
+	return authToken_;
+}
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseBackend::Result ofxSurfingSupabaseBackendSupabase::makeResult(const HttpResponse & res) {
+	Result result;
+	result.status = res.statusCode;
+	result.success = res.success;
+	if (!res.success) result.error = res.body;
+	result.retryAfterMs = res.retryAfterMs;
+	result.requests = res.requests;
+	result.bytesSent = res.bytesSent;
+	result.bytesReceived = res.bytesReceived;
+	return result;
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackendSupabase::parseRetryAfter(const std::string & retryAfter) {
+	// Delay in seconds; the HTTP-date form is not used by Supabase and is ignored
+	if (retryAfter.empty() || !std::all_of(retryAfter.begin(), retryAfter.end(), ::isdigit)) return -1;
+	try {
+		return static_cast<int>(std::min<long long>(std::stoll(retryAfter) * 1000, std::numeric_limits<int>::max()));
+	} catch (std::exception &) {
+		return -1;
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseBackendSupabase::parseRows(const std::string & body, std::vector<Row> & rows) {
+	try {
+		ofJson responseJson = ofJson::parse(body);
+
+		if (responseJson.is_array()) {
+			for (auto & item : responseJson) {
+				Row row;
+				if (parseRow(item, row)) rows.push_back(std::move(row));
+			}
+		}
+
+		return true;
+	} catch (std::exception & e) {
+		ofLogError("ofxSurfingSupabaseBackendSupabase") << "parseRows(): " << e.what();
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+int ofxSurfingSupabaseBackendSupabase::parseContentRangeTotal(const std::string & contentRange) {
+	// "0-24/3573" or "*/3573", total is "*" when not counted
+	std::size_t pos = contentRange.find('/');
+	if (pos == std::string::npos || pos + 1 >= contentRange.size()) return -1;
+
+	std::string total = contentRange.substr(pos + 1);
+	if (total == "*") return -1;
+
+	try {
+		return std::stoi(total);
+	} catch (std::exception &) {
+		return -1;
+	}
+}
+
+//--------------------------------------------------------------
+std::vector<std::vector<std::string>> ofxSurfingSupabaseBackendSupabase::splitNames(const std::vector<std::string> & names) const {
+	std::vector<std::vector<std::string>> chunks;
+	std::size_t bytes = 0;
+	for (auto & name : names) {
+		// Quoted, escaped and encoded as makeInList() does, plus the separator
+		std::size_t size = makeInList({ name }).size() - 1;
+		if (chunks.empty() || (bytes + size > IN_LIST_MAX_BYTES && !chunks.back().empty())) {
+			chunks.emplace_back();
+			bytes = 1;
+		}
+		chunks.back().push_back(name);
+		bytes += size;
+	}
+	return chunks;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendSupabase::makeInList(const std::vector<std::string> & names) {
+	// in.("a","b"): quoted so commas and parentheses in names survive
+	std::string list = "(";
+	for (std::size_t i = 0; i < names.size(); ++i) {
+		if (i > 0) list += ",";
+		std::string quoted;
+		for (char c : names[i]) {
+			if (c == '"' || c == '\\') quoted += '\\';
+			quoted += c;
+		}
+		list += urlEncode("\"" + quoted + "\"");
+	}
+	list += ")";
+	return list;
+}
+
+//--------------------------------------------------------------
+std::string ofxSurfingSupabaseBackendSupabase::urlEncode(const std::string & value) {
+	static const char * hex = "0123456789ABCDEF";
+
+	std::string encoded;
+	encoded.reserve(value.size() * 3);
+
+	for (unsigned char c : value) {
+		if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+			encoded += static_cast<char>(c);
+		} else {
+			encoded += '%';
+			encoded += hex[c >> 4];
+			encoded += hex[c & 0x0F];
+		}
+	}
+
+	return encoded;
+}
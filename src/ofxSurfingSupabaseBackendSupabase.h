@@ -0,0 +1,240 @@
+#pragma once
+
+#include "ofxSurfingSupabaseBackend.h"
+
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+namespace httplib {
+class SSLClient;
+}
+struct ssl_st;
+struct ssl_session_st;
+struct x509_store_st;
+
+/*
+	Supabase backend: PostgREST over HTTPS.
+
+	Rows live in the presets table, keyed by (user_id, preset_name).
+	Paged lists use Range headers and count=exact totals from Content-Range.
+
+	EMAIL_PASSWORD sessions are renewed in the background with the refresh
+	token, well before the access token expires (exp claim of the JWT).
+	A 401 still renews at once and retries the request.
+
+	Timeouts adapt per endpoint: an EWMA of the round-trip time of small
+	requests and of the throughput of large ones sizes the connect, read and
+	write timeouts, clamped between floors and ceilings.
+	Until an endpoint has been measured the fixed defaults apply.
+
+	Requests are rate limited client side (readRate, writeRate), so
+	autosave bursts queue up locally instead of drawing 429s.
+
+	Bulk loads and removes by name are split so that each in.(...) filter
+	stays within IN_LIST_MAX_BYTES of URL.
+
+	Built with CPPHTTPLIB_ZLIB_SUPPORT (and zlib linked), responses are
+	requested gzip encoded, and request bodies of at least compressThreshold
+	bytes are sent gzip encoded too. Both are timed for the ratio report.
+
+	Clients are pooled and keep their connection alive. Certificates are
+	verified by OpenSSL during the handshake against one CA store, loaded
+	once (CA_BUNDLE, or the system store) and shared by every client.
+	The last TLS session ticket is shared too, so a reconnect after idle
+	resumes with an abbreviated handshake.
+
+	The URL is parsed once. A request context, rebuilt whenever the session
+	token changes, holds the auth headers (installed as client defaults)
+	and the endpoint prefixes with the user filter already url-encoded,
+	so a request only appends its own encoded values.
+*/
+
+class ofxSurfingSupabaseBackendSupabase : public ofxSurfingSupabaseBackend {
+public:
+	struct Config {
+		std::string authMode;
+		std::string supabaseUrl;
+		std::string supabaseAnonKey;
+		std::string email;
+		std::string password;
+		int compressThreshold = 0; // Bytes, 0 sends request bodies uncompressed
+		std::string caBundle; // PEM file, empty for the system store
+		bool verifyTls = true;
+		double readRate = 10; // Requests per second, 0 for no limit
+		double writeRate = 5;
+		bool isValid() const;
+	};
+
+	explicit ofxSurfingSupabaseBackendSupabase(const Config & config);
+	~ofxSurfingSupabaseBackendSupabase();
+
+	std::string getName() const override { return "supabase"; }
+	CompressionStats getCompressionStats() const override;
+	TlsStats getTlsStats() const override;
+
+protected:
+	bool doConnect(std::string & userId) override;
+	Result doLoad(const std::string & name, const std::string & updatedAfter, Row & row) override;
+	Result doSave(const Row & row, bool overwrite, Row & saved) override;
+	Result doRemove(const std::string & name) override;
+	Result doList(const Query & query, std::vector<Row> & rows, int & total) override;
+	Result doListEach(const Query & query, const std::function<void(Row &)> & onRow, int & total) override;
+	Result doProbe(int & count, std::string & newest) override;
+	Result doLoadBulk(const std::vector<std::string> & names, std::vector<Row> & rows) override;
+	Result doSaveBulk(const std::vector<Row> & rows, bool overwrite, std::vector<Row> & saved) override;
+	Result doRemoveBulk(const std::vector<std::string> & names) override;
+	Result doRemoveAll() override;
+	std::vector<std::vector<std::string>> splitNames(const std::vector<std::string> & names) const override;
+
+private:
+	// HTTP Client
+	struct HttpResponse {
+		int statusCode = 0;
+		std::string body;
+		std::string contentRange;
+		int retryAfterMs = -1;
+		int requests = 0;
+		std::size_t bytesSent = 0; // Path and body on the wire, headers not counted
+		std::size_t bytesReceived = 0;
+		bool success = false;
+	};
+
+	// Fixed per request headers (content type, Prefer, encoding), prebuilt in the context
+	enum HeaderSet {
+		HEADERS_READ = 0,
+		HEADERS_COUNT,
+		HEADERS_UPSERT,
+		HEADERS_INSERT,
+		HEADERS_NUM
+	};
+
+	// A prebuilt path prefix; requests append their encoded values
+	struct Endpoint {
+		std::string method;
+		std::string path;
+		std::string timingKey;
+		HeaderSet headers = HEADERS_READ;
+	};
+
+	struct RequestContext;
+
+	// Takes a 2xx body as it arrives, false cancels the request
+	using BodyReceiver = std::function<bool(const char * data, std::size_t size)>;
+
+	HttpResponse httpGet(const Endpoint & endpoint, const std::string & suffix, const std::string & prefer = "", const std::string & range = "");
+	HttpResponse httpPost(const Endpoint & endpoint, const std::string & jsonBody);
+	HttpResponse httpDelete(const Endpoint & endpoint, const std::string & suffix);
+	HttpResponse httpRequest(const Endpoint & endpoint, const std::string & suffix, const std::string & body, const std::string & prefer, const std::string & range, const BodyReceiver & receiver = nullptr);
+	HttpResponse httpSend(const RequestContext & context, const Endpoint & endpoint, const std::string & suffix, const std::string & body, const std::string & prefer, const std::string & range, const BodyReceiver & receiver);
+
+	// Adaptive timeouts
+	struct Timeouts {
+		int connectMs;
+		int readMs;
+		int writeMs;
+	};
+	Timeouts getTimeouts(const std::string & key, std::size_t requestBytes) const;
+	void addTimingSample(const std::string & key, std::size_t requestBytes, std::size_t responseBytes, double elapsedMs, bool timedOut);
+
+	// Connections
+	struct PooledClient {
+		std::unique_ptr<httplib::SSLClient> client;
+		uint64_t revision = 0; // Of the context its default headers come from
+	};
+	PooledClient acquireClient(const RequestContext & context);
+	void releaseClient(PooledClient client);
+	std::unique_ptr<httplib::SSLClient> createClient();
+	x509_store_st * getCaStore();
+	static int onTlsNewSession(ssl_st * ssl, ssl_session_st * session);
+	static void onTlsInfo(const ssl_st * ssl, int where, int ret);
+
+	// Session renewal
+	bool requestToken(const std::string & grantType, const std::string & body, std::string & userId, int & status);
+	bool refreshSession(const std::string & staleToken);
+	void setSession(const std::string & accessToken, const std::string & refreshToken, int64_t expiresIn, const std::string & userId);
+	int64_t getRenewTime() const; // Unix seconds, 0 when the session never expires
+	void startRefreshThread();
+	void stopRefreshThread();
+	void refreshThreadFunction();
+	static bool parseTokenTimes(const std::string & token, int64_t & issuedAt, int64_t & expiresAt);
+
+	std::shared_ptr<const RequestContext> getContext() const;
+	std::string getAuthToken() const;
+	static Result makeResult(const HttpResponse & res);
+	static bool parseRows(const std::string & body, std::vector<Row> & rows);
+	static std::string makeListSuffix(const Query & query, std::string & range);
+	static int parseContentRangeTotal(const std::string & contentRange);
+	static int parseRetryAfter(const std::string & retryAfter);
+	static std::string makeInList(const std::vector<std::string> & names);
+	static std::string urlEncode(const std::string & value);
+
+	Config config_;
+	std::string scheme_; // Parsed from the URL once
+	std::string host_;
+	int port_ = 443;
+
+	mutable std::mutex authMutex_;
+	std::shared_ptr<const RequestContext> context_; // Replaced, never modified
+	uint64_t contextRevision_ = 0;
+	std::string authToken_;
+	std::string refreshToken_;
+	int64_t tokenIssuedAt_ = 0; // Unix seconds
+	int64_t tokenExpiresAt_ = 0;
+
+	std::mutex refreshCallMutex_; // One renewal at a time
+	std::thread refreshThread_;
+	std::atomic<bool> refreshThreadRunning_ { false };
+	std::mutex refreshMutex_;
+	std::condition_variable refreshCondition_;
+
+	struct Link {
+		double rttMs = 0; // EWMA over small requests
+		double bytesPerMs = 0; // EWMA over large ones, 0 until measured
+		double responseBytes = 0; // EWMA
+		int samples = 0;
+	};
+	mutable std::mutex linkMutex_;
+	std::map<std::string, Link> links_; // By method, path and selected columns
+	double linkRttMs_ = 0; // Across endpoints, the base latency for throughput
+
+	struct AtomicCompressionStats {
+		std::atomic<uint64_t> sentRaw { 0 };
+		std::atomic<uint64_t> sentWire { 0 };
+		std::atomic<uint64_t> receivedRaw { 0 };
+		std::atomic<uint64_t> receivedWire { 0 };
+		std::atomic<uint64_t> micros { 0 };
+	};
+	AtomicCompressionStats compressionStats_;
+
+	std::mutex clientPoolMutex_;
+	std::vector<PooledClient> clientPool_; // Idle, connection kept alive
+	std::once_flag caStoreOnce_;
+	x509_store_st * caStore_ = nullptr;
+	std::mutex tlsSessionMutex_;
+	ssl_session_st * tlsSession_ = nullptr; // Latest ticket, resumed by the next handshake
+
+	struct AtomicTlsStats {
+		std::atomic<uint64_t> requests { 0 };
+		std::atomic<uint64_t> fullHandshakes { 0 };
+		std::atomic<uint64_t> resumedHandshakes { 0 };
+		std::atomic<uint64_t> fullMicros { 0 };
+		std::atomic<uint64_t> resumedMicros { 0 };
+	};
+	AtomicTlsStats tlsStats_;
+
+	// Constants
+	static const std::string TABLE_NAME;
+	static const std::string PREFER_UPSERT_RETURN;
+	static const std::string PREFER_INSERT_RETURN;
+	static const int REFRESH_MARGIN_S = 60; // Renew at least this long before expiry
+	static const int REFRESH_RETRY_MIN_S = 5;
+	static const int REFRESH_RETRY_MAX_S = 300;
+	static const int TIMEOUT_DEFAULT_MS = 10000;
+	static const int TIMEOUT_CONNECT_FLOOR_MS = 1000;
+	static const int TIMEOUT_FLOOR_MS = 2000;
+	static const int TIMEOUT_CEILING_MS = 60000;
+	static const int TIMING_SMALL_BYTES = 16 * 1024; // Below this a request measures latency
+	static const int CLIENT_POOL_MAX = 8;
+	static const int IN_LIST_MAX_BYTES = 6000; // Encoded in.(...) per request, under the 8 KB URL limit of common proxies
+};
@@ -0,0 +1,587 @@
+#include "ofxSurfingSupabaseCache.h"
+
+#include "ofMain.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace {
+
+const uint32_t RECORD_MAGIC = 0x31505353; // "SSP1"
+const uint32_t INDEX_MAGIC = 0x31495353; // "SSI1"
+const uint32_t FLAG_TOMBSTONE = 1;
+
+// magic, flags, name size, updated_at size, payload size (u32 each) + payload hash (u64)
+const uint64_t HEADER_SIZE = 5 * sizeof(uint32_t) + sizeof(uint64_t);
+
+// Compact on open once superseded records exceed this and the live data
+const uint64_t COMPACT_MIN_DEAD_BYTES = 1024 * 1024;
+
+struct RecordHeader {
+	uint32_t magic;
+	uint32_t flags;
+	uint32_t nameSize;
+	uint32_t updatedAtSize;
+	uint32_t payloadSize;
+	uint64_t hash;
+
+	uint64_t recordSize() const { return HEADER_SIZE + nameSize + updatedAtSize + payloadSize; }
+};
+
+template <typename T>
+void appendValue(std::string & out, T value) {
+	out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(const char *& p, const char * end, T & value) {
+	if (end - p < static_cast<std::ptrdiff_t>(sizeof(T))) return false;
+	std::memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+	return true;
+}
+
+bool readString(const char *& p, const char * end, uint32_t size, std::string & value) {
+	if (end - p < static_cast<std::ptrdiff_t>(size)) return false;
+	value.assign(p, size);
+	p += size;
+	return true;
+}
+
+bool readHeader(const char * p, const char * end, RecordHeader & h) {
+	return readValue(p, end, h.magic) && readValue(p, end, h.flags)
+		&& readValue(p, end, h.nameSize) && readValue(p, end, h.updatedAtSize)
+		&& readValue(p, end, h.payloadSize) && readValue(p, end, h.hash)
+		&& h.magic == RECORD_MAGIC;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseCache::~ofxSurfingSupabaseCache() {
+	close();
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::open(const std::string & folder) {
+	close();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	folder_ = folder;
+	dataPath_ = ofFilePath::join(folder, "presets.dat");
+	indexPath_ = ofFilePath::join(folder, "presets.idx");
+	statePath_ = ofFilePath::join(folder, "state.json");
+
+	if (!ofDirectory::doesDirectoryExist(folder, false)) {
+		ofDirectory::createDirectory(folder, false, true);
+	}
+
+	std::error_code ec;
+	uint64_t fileSize = std::filesystem::exists(dataPath_, ec) ? std::filesystem::file_size(dataPath_, ec) : 0;
+
+	// The index covers the data file up to the size it recorded, the tail is scanned
+	if (!readIndex() || dataSize_ > fileSize) {
+		records_.clear();
+		dataSize_ = 0;
+		deadBytes_ = 0;
+	}
+	uint64_t scanFrom = dataSize_;
+	dataSize_ = fileSize;
+
+	if (!scanData(scanFrom)) {
+		// Torn tail from a crash mid-append: drop it so new records stay aligned
+		unmapData();
+		std::filesystem::resize_file(dataPath_, dataSize_, ec);
+		ofLogWarning("ofxSurfingSupabaseCache") << "open(): Truncated damaged tail at " << dataSize_ << " bytes";
+	}
+
+	dataFile_ = std::fopen(dataPath_.c_str(), "ab");
+	if (!dataFile_) {
+		ofLogError("ofxSurfingSupabaseCache") << "open(): Can't open " << dataPath_;
+		unmapData();
+		records_.clear();
+		return false;
+	}
+
+	if (deadBytes_ > COMPACT_MIN_DEAD_BYTES && deadBytes_ > dataSize_ - deadBytes_) {
+		compact();
+	}
+
+	if (indexDirty_) {
+		writeIndex();
+	}
+
+	ofLogNotice("ofxSurfingSupabaseCache") << "open(): " << records_.size() << " presets cached (" << dataSize_ / 1024 << " KB)";
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::close() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (dataFile_) {
+		if (indexDirty_) writeIndex();
+		std::fclose(dataFile_);
+		dataFile_ = nullptr;
+	}
+	unmapData();
+	records_.clear();
+	dataSize_ = 0;
+	deadBytes_ = 0;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::isOpen() const {
+	return dataFile_ != nullptr;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::get(const std::string & name, std::string & payload, Info & info) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = records_.find(name);
+	if (it == records_.end()) return false;
+
+	const Record & record = it->second;
+	uint64_t end = record.offset + HEADER_SIZE + name.size() + record.info.updatedAt.size() + record.payloadSize;
+	if (!mapData(end)) return false;
+
+	RecordHeader h;
+	if (!readHeader(mapped_ + record.offset, mapped_ + mappedSize_, h) || h.payloadSize != record.payloadSize) {
+		ofLogWarning("ofxSurfingSupabaseCache") << "get(): Bad record for " << name;
+		records_.erase(it);
+		indexDirty_ = true;
+		return false;
+	}
+
+	payload.assign(mapped_ + record.offset + HEADER_SIZE + h.nameSize + h.updatedAtSize, h.payloadSize);
+
+	if (hashPayload(payload) != h.hash) {
+		ofLogWarning("ofxSurfingSupabaseCache") << "get(): Hash mismatch for " << name;
+		records_.erase(it);
+		indexDirty_ = true;
+		return false;
+	}
+
+	info = record.info;
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::getInfo(const std::string & name, Info & info) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = records_.find(name);
+	if (it == records_.end()) return false;
+
+	info = it->second.info;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::put(const std::string & name, const std::string & payload, const std::string & updatedAt) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	appendRecord(name, payload, updatedAt, 0);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::erase(const std::string & name) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (records_.count(name) == 0) return;
+	appendRecord(name, "", "", FLAG_TOMBSTONE);
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!dataFile_) return;
+
+	std::fclose(dataFile_);
+	unmapData();
+
+	std::error_code ec;
+	std::filesystem::remove(indexPath_, ec);
+	std::filesystem::remove(statePath_, ec);
+
+	dataFile_ = std::fopen(dataPath_.c_str(), "wb");
+	records_.clear();
+	dataSize_ = 0;
+	deadBytes_ = 0;
+	indexDirty_ = true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::flush() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (dataFile_ && indexDirty_) writeIndex();
+}
+
+//--------------------------------------------------------------
+std::size_t ofxSurfingSupabaseCache::size() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return records_.size();
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::loadState(State & state) {
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		path = statePath_;
+	}
+	if (path.empty() || !ofFile::doesFileExist(path, false)) return false;
+
+	try {
+		ofJson json = ofLoadJson(path);
+		state.userId = json.value("user_id", "");
+		state.names = json.value("names", std::vector<std::string>());
+		state.selected = json.value("selected", "");
+		state.watermark = json.value("watermark", "");
+		state.replicaWatermark = json.value("replica_watermark", "");
+		state.synced = json.value("synced", false);
+		return true;
+	} catch (std::exception & e) {
+		ofLogWarning("ofxSurfingSupabaseCache") << "loadState(): " << e.what();
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::saveState(const State & state) {
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		path = statePath_;
+	}
+	if (path.empty()) return;
+
+	ofJson json;
+	json["user_id"] = state.userId;
+	json["names"] = state.names;
+	json["selected"] = state.selected;
+	json["watermark"] = state.watermark;
+	json["replica_watermark"] = state.replicaWatermark;
+	json["synced"] = state.synced;
+	ofSaveJson(path, json);
+}
+
+//--------------------------------------------------------------
+uint64_t ofxSurfingSupabaseCache::hashPayload(const std::string & payload) {
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char c : payload) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::appendRecord(const std::string & name, const std::string & payload, const std::string & updatedAt, uint32_t flags) {
+	if (!dataFile_) return;
+
+	RecordHeader h;
+	h.magic = RECORD_MAGIC;
+	h.flags = flags;
+	h.nameSize = static_cast<uint32_t>(name.size());
+	h.updatedAtSize = static_cast<uint32_t>(updatedAt.size());
+	h.payloadSize = static_cast<uint32_t>(payload.size());
+	h.hash = hashPayload(payload);
+
+	std::string buffer;
+	buffer.reserve(h.recordSize());
+	appendValue(buffer, h.magic);
+	appendValue(buffer, h.flags);
+	appendValue(buffer, h.nameSize);
+	appendValue(buffer, h.updatedAtSize);
+	appendValue(buffer, h.payloadSize);
+	appendValue(buffer, h.hash);
+	buffer += name;
+	buffer += updatedAt;
+	buffer += payload;
+
+	if (std::fwrite(buffer.data(), 1, buffer.size(), dataFile_) != buffer.size() || std::fflush(dataFile_) != 0) {
+		ofLogError("ofxSurfingSupabaseCache") << "appendRecord(): Write failed for " << name;
+		return;
+	}
+
+	auto it = records_.find(name);
+	if (it != records_.end()) {
+		deadBytes_ += HEADER_SIZE + name.size() + it->second.info.updatedAt.size() + it->second.payloadSize;
+	}
+
+	if (flags & FLAG_TOMBSTONE) {
+		records_.erase(name);
+		deadBytes_ += buffer.size();
+	} else {
+		Record & record = records_[name];
+		record.offset = dataSize_;
+		record.payloadSize = h.payloadSize;
+		record.info.updatedAt = updatedAt;
+		record.info.hash = h.hash;
+	}
+
+	dataSize_ += buffer.size();
+	indexDirty_ = true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::scanData(uint64_t from) {
+	if (from >= dataSize_) return true;
+	if (!mapData(dataSize_)) return false;
+
+	const char * end = mapped_ + dataSize_;
+	uint64_t pos = from;
+
+	while (pos < dataSize_) {
+		RecordHeader h;
+		if (!readHeader(mapped_ + pos, end, h) || pos + h.recordSize() > dataSize_) {
+			dataSize_ = pos;
+			return false;
+		}
+
+		std::string name(mapped_ + pos + HEADER_SIZE, h.nameSize);
+
+		auto it = records_.find(name);
+		if (it != records_.end()) {
+			deadBytes_ += HEADER_SIZE + name.size() + it->second.info.updatedAt.size() + it->second.payloadSize;
+		}
+
+		if (h.flags & FLAG_TOMBSTONE) {
+			records_.erase(name);
+			deadBytes_ += h.recordSize();
+		} else {
+			Record & record = records_[name];
+			record.offset = pos;
+			record.payloadSize = h.payloadSize;
+			record.info.updatedAt.assign(mapped_ + pos + HEADER_SIZE + h.nameSize, h.updatedAtSize);
+			record.info.hash = h.hash;
+		}
+
+		pos += h.recordSize();
+		indexDirty_ = true;
+	}
+
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::readIndex() {
+	std::ifstream file(indexPath_, std::ios::binary);
+	if (!file) return false;
+
+	std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	const char * p = buffer.data();
+	const char * end = p + buffer.size();
+
+	uint32_t magic = 0;
+	uint32_t count = 0;
+	if (!readValue(p, end, magic) || magic != INDEX_MAGIC
+		|| !readValue(p, end, dataSize_) || !readValue(p, end, deadBytes_)
+		|| !readValue(p, end, count)) {
+		return false;
+	}
+
+	records_.clear();
+	records_.reserve(count);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t nameSize = 0;
+		uint32_t updatedAtSize = 0;
+		std::string name;
+		Record record;
+
+		if (!readValue(p, end, nameSize) || !readString(p, end, nameSize, name)
+			|| !readValue(p, end, record.offset) || !readValue(p, end, record.payloadSize)
+			|| !readValue(p, end, record.info.hash)
+			|| !readValue(p, end, updatedAtSize) || !readString(p, end, updatedAtSize, record.info.updatedAt)) {
+			ofLogWarning("ofxSurfingSupabaseCache") << "readIndex(): Damaged index, rescanning";
+			return false;
+		}
+
+		records_.emplace(std::move(name), std::move(record));
+	}
+
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::writeIndex() {
+	std::string buffer;
+	appendValue(buffer, INDEX_MAGIC);
+	appendValue(buffer, dataSize_);
+	appendValue(buffer, deadBytes_);
+	appendValue(buffer, static_cast<uint32_t>(records_.size()));
+
+	for (auto & it : records_) {
+		appendValue(buffer, static_cast<uint32_t>(it.first.size()));
+		buffer += it.first;
+		appendValue(buffer, it.second.offset);
+		appendValue(buffer, it.second.payloadSize);
+		appendValue(buffer, it.second.info.hash);
+		appendValue(buffer, static_cast<uint32_t>(it.second.info.updatedAt.size()));
+		buffer += it.second.info.updatedAt;
+	}
+
+	// Write aside and swap in, so a crash never leaves a half written index
+	std::string tmpPath = indexPath_ + ".tmp";
+	{
+		std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+		file.write(buffer.data(), buffer.size());
+		if (!file) {
+			ofLogError("ofxSurfingSupabaseCache") << "writeIndex(): Write failed";
+			return;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpPath, indexPath_, ec);
+	if (ec) {
+		ofLogError("ofxSurfingSupabaseCache") << "writeIndex(): " << ec.message();
+		return;
+	}
+
+	indexDirty_ = false;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::compact() {
+	if (!mapData(dataSize_)) return;
+
+	ofLogNotice("ofxSurfingSupabaseCache") << "compact(): Reclaiming " << deadBytes_ / 1024 << " KB";
+
+	// Keep the original append order
+	std::vector<std::pair<uint64_t, std::string>> order;
+	order.reserve(records_.size());
+	for (auto & it : records_) {
+		order.emplace_back(it.second.offset, it.first);
+	}
+	std::sort(order.begin(), order.end());
+
+	std::string tmpPath = dataPath_ + ".tmp";
+	std::FILE * out = std::fopen(tmpPath.c_str(), "wb");
+	if (!out) return;
+
+	// New offsets stay aside until the new file is in place
+	std::unordered_map<std::string, uint64_t> offsets;
+	offsets.reserve(order.size());
+
+	uint64_t offset = 0;
+	for (auto & item : order) {
+		const Record & record = records_[item.second];
+		uint64_t size = HEADER_SIZE + item.second.size() + record.info.updatedAt.size() + record.payloadSize;
+		if (std::fwrite(mapped_ + record.offset, 1, size, out) != size) {
+			std::fclose(out);
+			std::filesystem::remove(tmpPath);
+			ofLogError("ofxSurfingSupabaseCache") << "compact(): Write failed";
+			return;
+		}
+		offsets[item.second] = offset;
+		offset += size;
+	}
+	std::fclose(out);
+
+	std::fclose(dataFile_);
+	unmapData();
+
+	std::error_code ec;
+	std::filesystem::rename(tmpPath, dataPath_, ec);
+	dataFile_ = std::fopen(dataPath_.c_str(), "ab");
+	if (ec) {
+		// The old file and its offsets are still valid, try again on the next compaction
+		ofLogError("ofxSurfingSupabaseCache") << "compact(): " << ec.message() << ", kept the old data file";
+		std::filesystem::remove(tmpPath, ec);
+		return;
+	}
+
+	for (auto & it : offsets) {
+		records_[it.first].offset = it.second;
+	}
+	dataSize_ = offset;
+	deadBytes_ = 0;
+	indexDirty_ = true;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseCache::mapData(uint64_t sizeNeeded) {
+	if (mapped_ && mappedSize_ >= sizeNeeded) return true;
+
+	// The file grew since it was mapped
+	unmapData();
+	if (dataSize_ == 0 || sizeNeeded > dataSize_) return false;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(dataPath_.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle_ = file;
+	mappingHandle_ = mapping;
+	mapped_ = static_cast<const char *>(view);
+#else
+	int fd = ::open(dataPath_.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	void * view = mmap(nullptr, dataSize_, PROT_READ, MAP_SHARED, fd, 0);
+	if (view == MAP_FAILED) {
+		::close(fd);
+		return false;
+	}
+
+	mappedFd_ = fd;
+	mapped_ = static_cast<const char *>(view);
+#endif
+
+	mappedSize_ = dataSize_;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseCache::unmapData() {
+	if (!mapped_) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(mapped_);
+	CloseHandle(static_cast<HANDLE>(mappingHandle_));
+	CloseHandle(static_cast<HANDLE>(fileHandle_));
+	mappingHandle_ = nullptr;
+	fileHandle_ = nullptr;
+#else
+	munmap(const_cast<char *>(mapped_), mappedSize_);
+	::close(mappedFd_);
+	mappedFd_ = -1;
+#endif
+
+	mapped_ = nullptr;
+	mappedSize_ = 0;
+}
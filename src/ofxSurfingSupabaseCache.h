@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+	Persistent on-disk preset cache.
+
+	presets.dat is append-only: every put() or erase() appends one record
+	(header + name + updated_at + payload), so a crash can at most lose the tail.
+	Records are read back through a memory mapping of the data file.
+	presets.idx maps each name to its newest record and is rewritten on flush().
+	Records appended after the last flush are recovered by scanning the tail.
+	state.json keeps the list order, the last selection and the sync watermark.
+
+	All methods are thread-safe.
+*/
+
+class ofxSurfingSupabaseCache {
+public:
+	struct Info {
+		std::string updatedAt; // Server time, empty while a local save is pending
+		uint64_t hash = 0;
+	};
+
+	struct State {
+		std::string userId;
+		std::vector<std::string> names;
+		std::string selected;
+		std::string watermark;
+		std::string replicaWatermark; // Local-first: max updated_at pulled with data
+		bool synced = false;
+	};
+
+	~ofxSurfingSupabaseCache();
+
+	bool open(const std::string & folder);
+	void close();
+	bool isOpen() const;
+
+	// Payload records
+	bool get(const std::string & name, std::string & payload, Info & info);
+	bool getInfo(const std::string & name, Info & info);
+	void put(const std::string & name, const std::string & payload, const std::string & updatedAt);
+	void erase(const std::string & name);
+	void clear();
+	void flush(); // Rewrites the index
+
+	std::size_t size();
+
+	// List state for warm start
+	bool loadState(State & state);
+	void saveState(const State & state);
+
+	static uint64_t hashPayload(const std::string & payload);
+
+private:
+	struct Record {
+		uint64_t offset = 0; // Header start in the data file
+		uint32_t payloadSize = 0;
+		Info info;
+	};
+
+	bool mapData(uint64_t sizeNeeded);
+	void unmapData();
+	bool scanData(uint64_t from);
+	bool readIndex();
+	void writeIndex();
+	void appendRecord(const std::string & name, const std::string & payload, const std::string & updatedAt, uint32_t flags);
+	void compact();
+
+	std::mutex mutex_;
+	std::string folder_;
+	std::string dataPath_;
+	std::string indexPath_;
+	std::string statePath_;
+
+	std::FILE * dataFile_ = nullptr;
+	uint64_t dataSize_ = 0;
+	uint64_t deadBytes_ = 0; // Superseded records, reclaimed by compact()
+	bool indexDirty_ = false;
+
+	std::unordered_map<std::string, Record> records_;
+
+	// Memory mapping
+	const char * mapped_ = nullptr;
+	uint64_t mappedSize_ = 0;
+#ifdef _WIN32
+	void * mappingHandle_ = nullptr;
+	void * fileHandle_ = nullptr;
+#else
+	int mappedFd_ = -1;
+#endif
+};
@@ -0,0 +1,311 @@
+#include "ofxSurfingSupabaseJournal.h"
+
+#include "ofMain.h"
+#include "ofxSurfingSupabaseCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace {
+
+const uint32_t ENTRY_MAGIC = 0x314A5353; // "SSJ1"
+
+// magic, op, user size, name size, payload size (u32 each) + seq + body hash (u64 each)
+const std::size_t HEADER_SIZE = 5 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+template <typename T>
+void appendValue(std::string & out, T value) {
+	out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(const char * p) {
+	T value;
+	std::memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+void syncFile(std::FILE * file) {
+	if (!file) return;
+	std::fflush(file);
+#ifdef _WIN32
+	_commit(_fileno(file));
+#else
+	fsync(fileno(file));
+#endif
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+ofxSurfingSupabaseJournal::~ofxSurfingSupabaseJournal() {
+	close();
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseJournal::open(const std::string & folder) {
+	close();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	logPath_ = ofFilePath::join(folder, "journal.log");
+	ackPath_ = ofFilePath::join(folder, "journal.ack");
+
+	if (!ofDirectory::doesDirectoryExist(folder, false)) {
+		ofDirectory::createDirectory(folder, false, true);
+	}
+
+	ackedSeq_ = 0;
+	ackFile_ = std::fopen(ackPath_.c_str(), "r+b");
+	if (ackFile_) {
+		uint64_t seq = 0;
+		if (std::fread(&seq, sizeof(seq), 1, ackFile_) == 1) ackedSeq_ = seq;
+	} else {
+		ackFile_ = std::fopen(ackPath_.c_str(), "w+b");
+	}
+
+	if (!scan(ackedSeq_)) {
+		ofLogWarning("ofxSurfingSupabaseJournal") << "open(): Dropped damaged tail";
+	}
+
+	logFile_ = std::fopen(logPath_.c_str(), "ab");
+	if (!logFile_ || !ackFile_) {
+		ofLogError("ofxSurfingSupabaseJournal") << "open(): Can't open journal in " << folder;
+		return false;
+	}
+
+	if (entries_.empty()) {
+		truncate();
+	}
+
+	ofLogNotice("ofxSurfingSupabaseJournal") << "open(): " << entries_.size() << " pending entries";
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::close() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (logFile_) {
+		syncFile(logFile_);
+		std::fclose(logFile_);
+		logFile_ = nullptr;
+	}
+	if (ackFile_) {
+		syncFile(ackFile_);
+		std::fclose(ackFile_);
+		ackFile_ = nullptr;
+	}
+	entries_.clear();
+}
+
+//--------------------------------------------------------------
+uint64_t ofxSurfingSupabaseJournal::append(Op op, const std::string & userId, const std::string & name, const std::string & payload) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Entry entry;
+	entry.seq = nextSeq_++;
+	entry.op = op;
+	entry.userId = userId;
+	entry.name = name;
+	entry.payload = payload;
+	entry.time = ofGetElapsedTimeMillis();
+
+	std::string body = userId + name + payload;
+
+	std::string buffer;
+	buffer.reserve(HEADER_SIZE + body.size());
+	appendValue(buffer, ENTRY_MAGIC);
+	appendValue(buffer, static_cast<uint32_t>(op));
+	appendValue(buffer, static_cast<uint32_t>(userId.size()));
+	appendValue(buffer, static_cast<uint32_t>(name.size()));
+	appendValue(buffer, static_cast<uint32_t>(payload.size()));
+	appendValue(buffer, entry.seq);
+	appendValue(buffer, ofxSurfingSupabaseCache::hashPayload(body));
+	buffer += body;
+
+	if (!logFile_ || std::fwrite(buffer.data(), 1, buffer.size(), logFile_) != buffer.size() || std::fflush(logFile_) != 0) {
+		ofLogError("ofxSurfingSupabaseJournal") << "append(): Write failed, entry kept in memory only";
+	}
+	logDirty_ = true;
+
+	entries_.push_back(std::move(entry));
+	return entries_.back().seq;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseJournal::front(Entry & entry) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (entries_.empty()) return false;
+	entry = entries_.front();
+	return true;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxSurfingSupabaseJournal::front(std::vector<Entry> & entries, std::size_t count) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries.assign(entries_.begin(), entries_.begin() + std::min(count, entries_.size()));
+	return entries.size();
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::pop(std::size_t count) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (entries_.empty()) return;
+
+	// One ack for the run: the last sequence number covers the ones before it
+	count = std::min(count, entries_.size());
+	ackedSeq_ = entries_[count - 1].seq;
+	entries_.erase(entries_.begin(), entries_.begin() + count);
+	writeAck();
+
+	if (entries_.empty()) {
+		truncate();
+	}
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::sync() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (logDirty_) {
+		syncFile(logFile_);
+		logDirty_ = false;
+	}
+	if (ackDirty_) {
+		syncFile(ackFile_);
+		ackDirty_ = false;
+	}
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!entries_.empty()) {
+		ackedSeq_ = entries_.back().seq;
+		entries_.clear();
+		writeAck();
+	}
+	truncate();
+}
+
+//--------------------------------------------------------------
+std::size_t ofxSurfingSupabaseJournal::size() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_.size();
+}
+
+//--------------------------------------------------------------
+uint64_t ofxSurfingSupabaseJournal::getOldestTime() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_.empty() ? 0 : entries_.front().time;
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> ofxSurfingSupabaseJournal::getPendingNames() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<std::string> names;
+	for (auto & entry : entries_) {
+		if (entry.op == OP_CLEAR) {
+			names.clear();
+		} else if (entry.op != OP_DELETE) {
+			names.push_back(entry.name);
+		}
+	}
+	return names;
+}
+
+//--------------------------------------------------------------
+bool ofxSurfingSupabaseJournal::scan(uint64_t ackedSeq) {
+	entries_.clear();
+	nextSeq_ = ackedSeq + 1;
+
+	std::ifstream file(logPath_, std::ios::binary);
+	if (!file) return true;
+
+	std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+
+	std::size_t pos = 0;
+	bool clean = true;
+
+	while (pos < buffer.size()) {
+		const char * p = buffer.data() + pos;
+		if (buffer.size() - pos < HEADER_SIZE || readValue<uint32_t>(p) != ENTRY_MAGIC) {
+			clean = false;
+			break;
+		}
+
+		uint32_t op = readValue<uint32_t>(p + 4);
+		if (op < OP_SAVE || op > OP_CLEAR) {
+			clean = false;
+			break;
+		}
+		uint32_t userSize = readValue<uint32_t>(p + 8);
+		uint32_t nameSize = readValue<uint32_t>(p + 12);
+		uint32_t payloadSize = readValue<uint32_t>(p + 16);
+		uint64_t seq = readValue<uint64_t>(p + 20);
+		uint64_t hash = readValue<uint64_t>(p + 28);
+
+		std::size_t bodySize = static_cast<std::size_t>(userSize) + nameSize + payloadSize;
+		if (buffer.size() - pos - HEADER_SIZE < bodySize) {
+			clean = false;
+			break;
+		}
+
+		std::string body(p + HEADER_SIZE, bodySize);
+		if (ofxSurfingSupabaseCache::hashPayload(body) != hash) {
+			clean = false;
+			break;
+		}
+
+		if (seq > ackedSeq) {
+			Entry entry;
+			entry.seq = seq;
+			entry.op = static_cast<Op>(op);
+			entry.userId = body.substr(0, userSize);
+			entry.name = body.substr(userSize, nameSize);
+			entry.payload = body.substr(userSize + nameSize);
+			entry.time = ofGetElapsedTimeMillis();
+			entries_.push_back(std::move(entry));
+		}
+		nextSeq_ = std::max(nextSeq_, seq + 1);
+
+		pos += HEADER_SIZE + bodySize;
+	}
+
+	if (!clean) {
+		// Torn write from a crash: keep what was complete
+		std::error_code ec;
+		std::filesystem::resize_file(logPath_, pos, ec);
+	}
+
+	return clean;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::writeAck() {
+	if (!ackFile_) return;
+
+	std::fseek(ackFile_, 0, SEEK_SET);
+	std::fwrite(&ackedSeq_, sizeof(ackedSeq_), 1, ackFile_);
+	std::fflush(ackFile_);
+	ackDirty_ = true;
+}
+
+//--------------------------------------------------------------
+void ofxSurfingSupabaseJournal::truncate() {
+	// Everything is acknowledged: restart the log, sequence numbers keep growing
+	if (logFile_) std::fclose(logFile_);
+	logFile_ = std::fopen(logPath_.c_str(), "wb");
+	logDirty_ = true;
+}
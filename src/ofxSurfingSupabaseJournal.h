@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+	Durable write-ahead journal for remote mutations.
+
+	Saves and deletes are appended to journal.log before they are sent,
+	and replayed in order by a worker until acknowledged with pop().
+	Appends are flushed at once but fsynced in batches by sync(), so
+	many saves in a burst share a single disk sync.
+	journal.ack holds the sequence number of the last acknowledged entry.
+	The log is truncated whenever the queue drains.
+
+	All methods are thread-safe.
+*/
+
+class ofxSurfingSupabaseJournal {
+public:
+	enum Op : uint8_t {
+		OP_SAVE = 1, // Upsert on (user_id, preset_name)
+		OP_SAVE_NEW = 2, // Insert, renamed on conflict
+		OP_DELETE = 3,
+		OP_CLEAR = 4 // Every preset of the user
+	};
+
+	struct Entry {
+		uint64_t seq = 0;
+		Op op = OP_SAVE;
+		std::string userId;
+		std::string name;
+		std::string payload;
+		uint64_t time = 0; // Append time in ms, not persisted: restored entries get the open time
+	};
+
+	~ofxSurfingSupabaseJournal();
+
+	bool open(const std::string & folder);
+	void close();
+
+	uint64_t append(Op op, const std::string & userId, const std::string & name, const std::string & payload);
+	bool front(Entry & entry);
+	std::size_t front(std::vector<Entry> & entries, std::size_t count); // Up to count entries from the front
+	void pop(std::size_t count = 1); // Acknowledges the front entries
+	void sync(); // fsyncs pending appends and acks
+	void clear();
+
+	std::size_t size();
+	uint64_t getOldestTime(); // Append time of the front entry, 0 when empty
+	std::vector<std::string> getPendingNames(); // Names with a pending save, after the last clear
+
+private:
+	bool scan(uint64_t ackedSeq);
+	void writeAck();
+	void truncate();
+
+	std::mutex mutex_;
+	std::string logPath_;
+	std::string ackPath_;
+
+	std::FILE * logFile_ = nullptr;
+	std::FILE * ackFile_ = nullptr;
+	bool logDirty_ = false;
+	bool ackDirty_ = false;
+
+	std::deque<Entry> entries_;
+	uint64_t nextSeq_ = 1;
+	uint64_t ackedSeq_ = 0;
+};